@@ -3,16 +3,94 @@
 
 #include <cstdint>
 
+//===public structs==========
+// data a system touches, update systems that don't share written data are free to run at the same time.
+enum SYSTEM_ACCESS : uint64_t {
+    SYSTEM_ACCESS_NONE = 0u,
+    SYSTEM_ACCESS_TIME = 1u << 0u,
+    SYSTEM_ACCESS_WINDOW = 1u << 1u,
+    SYSTEM_ACCESS_INPUT = 1u << 2u,
+    SYSTEM_ACCESS_NET = 1u << 3u,
+
+    SYSTEM_ACCESS_TRANSFORM = 1u << 8u,
+    SYSTEM_ACCESS_UI_TRANSFORM = 1u << 9u,
+    SYSTEM_ACCESS_CAMERA = 1u << 10u,
+    SYSTEM_ACCESS_ENTITY = 1u << 11u,
+    SYSTEM_ACCESS_MATERIAL = 1u << 12u,
+    SYSTEM_ACCESS_MESH = 1u << 13u,
+    SYSTEM_ACCESS_TEXTURE = 1u << 14u,
+    SYSTEM_ACCESS_GFX = 1u << 15u,
+
+    SYSTEM_ACCESS_ALL = UINT64_MAX,
+};
+
+struct SystemDesc {
+    const char *name;
+    void (*func)();
+    uint64_t read;
+    uint64_t write;
+    bool mainThread; // windowing & presentation have to stay on the thread that created them.
+};
+
+// stats over the last 256 runs of a system, name stays valid until engine_cleanup.
+struct SystemTimingStats {
+    const char *name;
+    double minMs;
+    double avgMs;
+    double maxMs;
+    double p99Ms;
+    uint32_t sampleCount;
+};
+
 //===api=====================
+// false once the window closes, a run limit is hit or a quit was requested.
 bool engine_is_open();
 
+// headless runs skip the window & gfx systems, it's up to the runtime to not register them.
+void engine_set_headless(bool headless);
+bool engine_is_headless();
+// 0 disables the limit.
+void engine_set_run_limits(uint64_t maxFrames, double maxSeconds);
+void engine_request_quit();
+// supports: -headless -frames <count> -seconds <seconds>
+void engine_apply_commandline(int32_t argc, char **argv);
+
 void engine_system_create();
 void engine_system_update();
 void engine_system_cleanup();
 
-void engine_register_system_create(uint32_t priority, void(*ptr)());
+// create & cleanup systems run one after another in priority order, name is what their timings are logged under.
+void engine_register_system_create(uint32_t priority, const char *name, void(*ptr)());
 void engine_register_system_update(uint32_t priority, void(*ptr)());
-void engine_register_system_cleanup(uint32_t priority, void(*ptr)());
+void engine_register_system_cleanup(uint32_t priority, const char *name, void(*ptr)());
+
+// priority only orders systems that conflict, everything else is scheduled by the declared access.
+void engine_register_system_update(uint32_t priority, const SystemDesc &desc);
+
+// each frame runs: update systems -> 0..N fixed update steps -> render systems.
+void engine_register_system_fixed_update(uint32_t priority, void(*ptr)());
+void engine_register_system_fixed_update(uint32_t priority, const SystemDesc &desc);
+void engine_register_system_render(uint32_t priority, void(*ptr)());
+void engine_register_system_render(uint32_t priority, const SystemDesc &desc);
+
+// time left over after the fixed steps is carried to the next frame, frames needing more than maxSteps drop the excess.
+void engine_set_fixed_timestep(double fixedDelta, uint32_t maxSteps);
+double engine_fixed_delta();
+// [0, 1) progress between the last & next fixed step, used by render systems to interpolate simulation state.
+double engine_fixed_alpha();
+uint64_t engine_fixed_tick();
+
+// asserts the currently executing update system declared the given access, no-op outside of debug builds.
+void engine_validate_system_access(uint64_t read, uint64_t write);
+
+// every registered system is timed each time it runs, indices follow registration order.
+uint32_t engine_system_timing_count();
+SystemTimingStats engine_system_timing_stats(uint32_t index);
+SystemTimingStats engine_frame_timing_stats();
+void engine_log_system_timings();
+
+// writes the update system graph as a graphviz .dot file.
+void engine_export_system_graph(const char *path);
 
 //===init & shutdown=========
 void engine_create();
@@ -0,0 +1,37 @@
+#ifndef BEETROOT_ENGINE_JOBS_H
+#define BEETROOT_ENGINE_JOBS_H
+
+#include <atomic>
+#include <cstdint>
+
+//===public structs==========
+// tracks the amount of in-flight jobs submitted against it, zero once all of them have finished.
+struct JobCounter {
+    std::atomic<uint32_t> value{0};
+};
+
+typedef void (*JobFunc)(void *args);
+typedef void (*JobRangeFunc)(void *args, uint32_t begin, uint32_t end);
+
+struct JobDesc {
+    JobFunc func;
+    void *args;
+};
+
+//===api=====================
+// INFO: jobs can only be submitted & waited on from worker threads (the thread that called engine_job_create is worker 0)
+void engine_job_submit(const JobDesc *jobs, uint32_t jobCount, JobCounter *counter);
+void engine_job_wait(JobCounter *counter);
+
+// splits [0, count) into batches of batchSize and blocks until every batch has been executed.
+// a batchSize of 0 lets the job system pick a batch size based on the worker count.
+void engine_job_parallel_for(uint32_t count, uint32_t batchSize, JobRangeFunc func, void *args);
+
+uint32_t engine_job_worker_count();
+uint32_t engine_job_worker_index();
+
+//===init & shutdown=========
+void engine_job_create();
+void engine_job_cleanup();
+
+#endif //BEETROOT_ENGINE_JOBS_H
@@ -1,67 +1,542 @@
 //===defines=================
 #include <core/engine.h>
+#include <core/engine_jobs.h>
 #include <core/window.h>
+#include <core/time.h>
 #include <shared/assert.h>
+#include <shared/log.h>
+#include <shared/profiler.h>
+#include <shared/mem_tracker.h>
 
 #include <map>
+#include <vector>
+#include <atomic>
+#include <cstdio>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <chrono>
+#include <algorithm>
+
+#define BEET_ENGINE_ACCESS_BITS 64u
+#define BEET_ENGINE_DEFAULT_FIXED_DELTA (1.0 / 60.0)
+#define BEET_ENGINE_DEFAULT_MAX_FIXED_STEPS 5u
+#define BEET_ENGINE_TIMING_SAMPLES 256u
 
 //===internal structs========
+struct SystemTiming {
+    std::string name;
+    float samplesMs[BEET_ENGINE_TIMING_SAMPLES];
+    uint32_t nextSample;
+    uint32_t sampleCount;
+};
+
+struct RegisteredSystem {
+    SystemDesc desc;
+    uint32_t timingIndex;
+};
+
+struct SystemNode {
+    SystemDesc desc;
+    uint32_t timingIndex;
+    uint32_t priority;
+    uint32_t level;
+    std::vector<uint32_t> dependencies;
+};
+
+struct SystemGraph {
+    std::map<uint32_t, RegisteredSystem> systems;
+
+    // rebuilt whenever a system is registered.
+    std::vector<SystemNode> nodes;
+    std::vector<std::vector<uint32_t>> levels;
+    bool dirty{true};
+};
+
 struct Engine {
-    std::map<uint32_t, void (*)()> createSystems;
-    std::map<uint32_t, void (*)()> cleanupSystems;
-    std::map<uint32_t, void (*)()> updateSystems;
+    std::map<uint32_t, RegisteredSystem> createSystems;
+    std::map<uint32_t, RegisteredSystem> cleanupSystems;
+
+    SystemGraph updateGraph;
+    SystemGraph fixedUpdateGraph;
+    SystemGraph renderGraph;
+    std::vector<JobDesc> levelJobs;
+
+    double fixedDelta{BEET_ENGINE_DEFAULT_FIXED_DELTA};
+    uint32_t maxFixedSteps{BEET_ENGINE_DEFAULT_MAX_FIXED_STEPS};
+    double fixedAccumulator{0.0};
+    double fixedAlpha{0.0};
+    uint64_t fixedTick{0};
+
+    // indexed by RegisteredSystem::timingIndex, only ever written by the thread running that system.
+    std::vector<SystemTiming> systemTimings;
+    SystemTiming frameTiming{"frame"};
+
+    // headless runs have no window to close, so they rely on the frame / time limits or an explicit quit.
+    bool headless{false};
+    bool quitRequested{false};
+    uint64_t frameCount{0};
+    uint64_t maxFrames{0};
+    double maxSeconds{0.0};
+    double startTimeMs{0.0};
+
+#if BEET_DEBUG
+    std::atomic<uint32_t> activeReaders[BEET_ENGINE_ACCESS_BITS]{};
+    std::atomic<uint32_t> activeWriters[BEET_ENGINE_ACCESS_BITS]{};
+#endif
 };
 
 Engine *g_engine;
 
+static thread_local const SystemDesc *s_activeSystem = nullptr;
+
 //===internal functions======
+static bool systems_conflict(const SystemDesc &a, const SystemDesc &b) {
+    if (a.mainThread && b.mainThread) {
+        return true;
+    }
+    return (a.write & (b.read | b.write)) != 0 || (a.read & b.write) != 0;
+}
+
+static void build_system_graph(SystemGraph &systemGraph) {
+    std::vector<SystemNode> &graph = systemGraph.nodes;
+    graph.clear();
+    for (const auto &sys: systemGraph.systems) {
+        SystemNode node{};
+        node.desc = sys.second.desc;
+        node.timingIndex = sys.second.timingIndex;
+        node.priority = sys.first;
+        graph.push_back(node);
+    }
+
+    // conflicting systems keep their priority order, the level is the longest dependency chain leading into a system.
+    uint32_t levelCount = 0;
+    for (uint32_t i = 0; i < graph.size(); ++i) {
+        SystemNode &node = graph[i];
+        for (uint32_t j = 0; j < i; ++j) {
+            if (systems_conflict(graph[j].desc, node.desc)) {
+                node.dependencies.push_back(j);
+                node.level = graph[j].level + 1 > node.level ? graph[j].level + 1 : node.level;
+            }
+        }
+        levelCount = node.level + 1 > levelCount ? node.level + 1 : levelCount;
+    }
+
+    std::vector<std::vector<uint32_t>> &levels = systemGraph.levels;
+    levels.clear();
+    levels.resize(levelCount);
+    for (uint32_t i = 0; i < graph.size(); ++i) {
+        levels[graph[i].level].push_back(i);
+    }
+
+#if BEET_DEBUG
+    for (const auto &level: levels) {
+        for (uint32_t a = 0; a < level.size(); ++a) {
+            for (uint32_t b = a + 1; b < level.size(); ++b) {
+                const SystemDesc &descA = graph[level[a]].desc;
+                const SystemDesc &descB = graph[level[b]].desc;
+                ASSERT_MSG(!systems_conflict(descA, descB), "Err: systems [%s] & [%s] conflict but share a level", descA.name, descB.name);
+            }
+        }
+    }
+#endif
+
+    systemGraph.dirty = false;
+}
+
+#if BEET_DEBUG
+static void debug_access_begin(const SystemDesc &desc) {
+    for (uint32_t bit = 0; bit < BEET_ENGINE_ACCESS_BITS; ++bit) {
+        const uint64_t mask = uint64_t(1) << bit;
+        if (desc.write & mask) {
+            const uint32_t writers = g_engine->activeWriters[bit].fetch_add(1, std::memory_order_acq_rel);
+            const uint32_t readers = g_engine->activeReaders[bit].load(std::memory_order_acquire);
+            ASSERT_MSG(writers == 0 && readers == 0, "Err: system [%s] writes access bit %u while it is in use", desc.name, bit);
+        } else if (desc.read & mask) {
+            g_engine->activeReaders[bit].fetch_add(1, std::memory_order_acq_rel);
+            const uint32_t writers = g_engine->activeWriters[bit].load(std::memory_order_acquire);
+            ASSERT_MSG(writers == 0, "Err: system [%s] reads access bit %u while it is being written", desc.name, bit);
+        }
+    }
+}
+
+static void debug_access_end(const SystemDesc &desc) {
+    for (uint32_t bit = 0; bit < BEET_ENGINE_ACCESS_BITS; ++bit) {
+        const uint64_t mask = uint64_t(1) << bit;
+        if (desc.write & mask) {
+            g_engine->activeWriters[bit].fetch_sub(1, std::memory_order_acq_rel);
+        } else if (desc.read & mask) {
+            g_engine->activeReaders[bit].fetch_sub(1, std::memory_order_acq_rel);
+        }
+    }
+}
+#endif
+
+static double timer_now_ms() {
+    using namespace std::chrono;
+    return duration<double, std::milli>(steady_clock::now().time_since_epoch()).count();
+}
+
+static void record_timing(SystemTiming &timing, const double ms) {
+    timing.samplesMs[timing.nextSample] = (float) ms;
+    timing.nextSample = (timing.nextSample + 1) % BEET_ENGINE_TIMING_SAMPLES;
+    timing.sampleCount = timing.sampleCount < BEET_ENGINE_TIMING_SAMPLES ? timing.sampleCount + 1 : BEET_ENGINE_TIMING_SAMPLES;
+}
+
+static SystemTimingStats calculate_timing_stats(const SystemTiming &timing) {
+    SystemTimingStats stats{};
+    stats.name = timing.name.c_str();
+    stats.sampleCount = timing.sampleCount;
+    if (timing.sampleCount == 0) {
+        return stats;
+    }
+
+    float sorted[BEET_ENGINE_TIMING_SAMPLES];
+    std::copy(timing.samplesMs, timing.samplesMs + timing.sampleCount, sorted);
+    std::sort(sorted, sorted + timing.sampleCount);
+
+    double total = 0.0;
+    for (uint32_t i = 0; i < timing.sampleCount; ++i) {
+        total += sorted[i];
+    }
+    const uint32_t p99Index = (uint32_t) ceil(0.99 * timing.sampleCount) - 1;
+    stats.minMs = sorted[0];
+    stats.maxMs = sorted[timing.sampleCount - 1];
+    stats.avgMs = total / timing.sampleCount;
+    stats.p99Ms = sorted[p99Index];
+    return stats;
+}
+
+static uint32_t add_system_timing(const char *phase, uint32_t priority, const char *name) {
+    char timingName[256];
+    snprintf(timingName, sizeof(timingName), "%s[%u] %s", phase, priority, name);
+
+    SystemTiming timing{};
+    timing.name = timingName;
+    g_engine->systemTimings.push_back(timing);
+    return (uint32_t) g_engine->systemTimings.size() - 1;
+}
+
+static void run_system(const SystemDesc &desc, const uint32_t timingIndex) {
+#if BEET_DEBUG
+    debug_access_begin(desc);
+#endif
+    BEET_PROFILE_SCOPE(desc.name);
+    const double start = timer_now_ms();
+    s_activeSystem = &desc;
+    desc.func();
+    s_activeSystem = nullptr;
+    record_timing(g_engine->systemTimings[timingIndex], timer_now_ms() - start);
+#if BEET_DEBUG
+    debug_access_end(desc);
+#endif
+}
+
+static void run_system_job(void *args) {
+    const SystemNode *node = (const SystemNode *) args;
+    run_system(node->desc, node->timingIndex);
+}
+
+static void run_system_graph(SystemGraph &systemGraph) {
+    if (systemGraph.dirty) {
+        build_system_graph(systemGraph);
+    }
+
+    const std::vector<SystemNode> &graph = systemGraph.nodes;
+    std::vector<JobDesc> &jobs = g_engine->levelJobs;
+    for (const auto &level: systemGraph.levels) {
+        if (level.size() == 1) {
+            run_system(graph[level[0]].desc, graph[level[0]].timingIndex);
+            continue;
+        }
+
+        jobs.clear();
+        for (const uint32_t index: level) {
+            if (!graph[index].desc.mainThread) {
+                jobs.push_back(JobDesc{run_system_job, (void *) &graph[index]});
+            }
+        }
+
+        JobCounter counter{};
+        if (!jobs.empty()) {
+            engine_job_submit(jobs.data(), (uint32_t) jobs.size(), &counter);
+        }
+        for (const uint32_t index: level) {
+            if (graph[index].desc.mainThread) {
+                run_system(graph[index].desc, graph[index].timingIndex);
+            }
+        }
+        engine_job_wait(&counter);
+    }
+}
+
+static SystemDesc system_desc_from_function(void(*ptr)()) {
+    // systems without declared access are treated as touching everything, which keeps them in strict priority order.
+    SystemDesc desc{};
+    desc.name = "unnamed";
+    desc.func = ptr;
+    desc.read = SYSTEM_ACCESS_ALL;
+    desc.write = SYSTEM_ACCESS_ALL;
+    desc.mainThread = true;
+    return desc;
+}
+
+static void register_system(SystemGraph &systemGraph, const char *phase, uint32_t priority, const SystemDesc &desc) {
+    ASSERT_MSG(systemGraph.systems.count(priority) == 0, "Err: %s system already exists with this priority", phase);
+    ASSERT_MSG(desc.func != nullptr, "Err: system [%s] has no function", desc.name);
+    systemGraph.systems[priority] = RegisteredSystem{desc, add_system_timing(phase, priority, desc.name)};
+    systemGraph.dirty = true;
+}
+
+static void run_fixed_update_steps() {
+    g_engine->fixedAccumulator += time_delta();
+    uint32_t steps = 0;
+    while (g_engine->fixedAccumulator >= g_engine->fixedDelta && steps < g_engine->maxFixedSteps) {
+        run_system_graph(g_engine->fixedUpdateGraph);
+        g_engine->fixedAccumulator -= g_engine->fixedDelta;
+        g_engine->fixedTick++;
+        steps++;
+    }
+    if (g_engine->fixedAccumulator >= g_engine->fixedDelta) {
+        // out of catch up steps, drop the whole steps we couldn't run so a slow frame can't spiral into slower frames.
+        g_engine->fixedAccumulator = fmod(g_engine->fixedAccumulator, g_engine->fixedDelta);
+    }
+    g_engine->fixedAlpha = g_engine->fixedAccumulator / g_engine->fixedDelta;
+}
+
+static void export_system_graph(FILE *file, SystemGraph &systemGraph, const char *phase) {
+    if (systemGraph.dirty) {
+        build_system_graph(systemGraph);
+    }
+
+    const std::vector<SystemNode> &graph = systemGraph.nodes;
+    fprintf(file, "    subgraph cluster_%s {\n", phase);
+    fprintf(file, "        label=\"%s\";\n", phase);
+    for (uint32_t i = 0; i < graph.size(); ++i) {
+        const SystemNode &node = graph[i];
+        fprintf(file, "        %s_%u [label=\"%s\\npriority: %u\\nlevel: %u%s\"];\n",
+                phase, i, node.desc.name, node.priority, node.level, node.desc.mainThread ? "\\nmain thread" : "");
+    }
+
+    // skip edges that are already implied by a longer path, otherwise systems touching everything flood the graph.
+    std::vector<std::vector<bool>> reachable(graph.size(), std::vector<bool>(graph.size(), false));
+    for (uint32_t i = 0; i < graph.size(); ++i) {
+        for (const uint32_t dep: graph[i].dependencies) {
+            reachable[i][dep] = true;
+            for (uint32_t k = 0; k < dep; ++k) {
+                if (reachable[dep][k]) {
+                    reachable[i][k] = true;
+                }
+            }
+        }
+    }
+    for (uint32_t i = 0; i < graph.size(); ++i) {
+        for (const uint32_t dep: graph[i].dependencies) {
+            bool implied = false;
+            for (const uint32_t other: graph[i].dependencies) {
+                if (other != dep && reachable[other][dep]) {
+                    implied = true;
+                    break;
+                }
+            }
+            if (!implied) {
+                fprintf(file, "        %s_%u -> %s_%u;\n", phase, dep, phase, i);
+            }
+        }
+    }
+    fprintf(file, "    }\n");
+}
 
 //===api=====================
-void engine_register_system_create(uint32_t priority, void(*ptr)()) {
+void engine_register_system_create(uint32_t priority, const char *name, void(*ptr)()) {
     ASSERT_MSG(g_engine->createSystems.count(priority) == 0, "Err: create system already exists with this priority");
-    g_engine->createSystems[priority] = ptr;
+    SystemDesc desc = system_desc_from_function(ptr);
+    desc.name = name;
+    g_engine->createSystems[priority] = RegisteredSystem{desc, add_system_timing("create", priority, desc.name)};
 }
 
 void engine_register_system_update(uint32_t priority, void(*ptr)()) {
-    ASSERT_MSG(g_engine->updateSystems.count(priority) == 0, "Err: update system already exists with this priority");
-    g_engine->updateSystems[priority] = ptr;
+    register_system(g_engine->updateGraph, "update", priority, system_desc_from_function(ptr));
+}
+
+void engine_register_system_update(uint32_t priority, const SystemDesc &desc) {
+    register_system(g_engine->updateGraph, "update", priority, desc);
 }
 
-void engine_register_system_cleanup(uint32_t priority, void(*ptr)()) {
+void engine_register_system_fixed_update(uint32_t priority, void(*ptr)()) {
+    register_system(g_engine->fixedUpdateGraph, "fixed_update", priority, system_desc_from_function(ptr));
+}
+
+void engine_register_system_fixed_update(uint32_t priority, const SystemDesc &desc) {
+    register_system(g_engine->fixedUpdateGraph, "fixed_update", priority, desc);
+}
+
+void engine_register_system_render(uint32_t priority, void(*ptr)()) {
+    register_system(g_engine->renderGraph, "render", priority, system_desc_from_function(ptr));
+}
+
+void engine_register_system_render(uint32_t priority, const SystemDesc &desc) {
+    register_system(g_engine->renderGraph, "render", priority, desc);
+}
+
+void engine_register_system_cleanup(uint32_t priority, const char *name, void(*ptr)()) {
     ASSERT_MSG(g_engine->cleanupSystems.count(priority) == 0, "Err: cleanup system already exists with this priority");
-    g_engine->cleanupSystems[priority] = ptr;
+    SystemDesc desc = system_desc_from_function(ptr);
+    desc.name = name;
+    g_engine->cleanupSystems[priority] = RegisteredSystem{desc, add_system_timing("cleanup", priority, desc.name)};
 }
 
 void engine_system_create() {
     for (const auto &sys: g_engine->createSystems) {
-        sys.second();
+        run_system(sys.second.desc, sys.second.timingIndex);
     }
 }
 
 void engine_system_update() {
-    for (const auto &sys: g_engine->updateSystems) {
-        sys.second();
-    }
+    BEET_PROFILE_FRAME_MARK();
+    BEET_PROFILE_SCOPE("engine_system_update");
+    const double frameStart = timer_now_ms();
+    run_system_graph(g_engine->updateGraph);
+    run_fixed_update_steps();
+    run_system_graph(g_engine->renderGraph);
+    record_timing(g_engine->frameTiming, timer_now_ms() - frameStart);
+    g_engine->frameCount++;
+    mem_tracker_next_frame();
+}
+
+void engine_set_fixed_timestep(double fixedDelta, uint32_t maxSteps) {
+    ASSERT_MSG(fixedDelta > 0.0, "Err: fixed delta must be greater than 0");
+    ASSERT_MSG(maxSteps > 0, "Err: at least one fixed step per frame is required");
+    g_engine->fixedDelta = fixedDelta;
+    g_engine->maxFixedSteps = maxSteps;
+}
+
+double engine_fixed_delta() {
+    return g_engine->fixedDelta;
+}
+
+double engine_fixed_alpha() {
+    return g_engine->fixedAlpha;
+}
+
+uint64_t engine_fixed_tick() {
+    return g_engine->fixedTick;
 }
 
 void engine_system_cleanup() {
     // iterate over the cleanup systems in reverse.
     auto &cleanupSystems = g_engine->cleanupSystems;
     for (auto sys = cleanupSystems.rbegin(); sys != cleanupSystems.rend(); sys++) {
-        sys->second();
+        run_system(sys->second.desc, sys->second.timingIndex);
+    }
+}
+
+void engine_export_system_graph(const char *path) {
+    FILE *file = fopen(path, "w");
+    ASSERT_MSG(file != nullptr, "Err: failed to open [%s] for writing", path);
+
+    fprintf(file, "digraph systems {\n");
+    fprintf(file, "    rankdir=LR;\n");
+    fprintf(file, "    node [shape=box];\n");
+    export_system_graph(file, g_engine->updateGraph, "update");
+    export_system_graph(file, g_engine->fixedUpdateGraph, "fixed_update");
+    export_system_graph(file, g_engine->renderGraph, "render");
+    fprintf(file, "}\n");
+    fclose(file);
+}
+
+void engine_validate_system_access(uint64_t read, uint64_t write) {
+#if BEET_DEBUG
+    const SystemDesc *active = s_activeSystem;
+    ASSERT_MSG(active != nullptr, "Err: access validated outside of an update system");
+    ASSERT_MSG((active->write & write) == write, "Err: system [%s] writes undeclared access", active->name);
+    ASSERT_MSG(((active->read | active->write) & read) == read, "Err: system [%s] reads undeclared access", active->name);
+#endif
+}
+
+uint32_t engine_system_timing_count() {
+    return (uint32_t) g_engine->systemTimings.size();
+}
+
+SystemTimingStats engine_system_timing_stats(uint32_t index) {
+    ASSERT_MSG(index < g_engine->systemTimings.size(), "Err: system timing index [%u] out of range", index);
+    return calculate_timing_stats(g_engine->systemTimings[index]);
+}
+
+SystemTimingStats engine_frame_timing_stats() {
+    return calculate_timing_stats(g_engine->frameTiming);
+}
+
+void engine_log_system_timings() {
+    const SystemTimingStats frame = engine_frame_timing_stats();
+    log_info(MSG_ENGINE, "%-48s min: %7.3fms avg: %7.3fms max: %7.3fms p99: %7.3fms (%u samples)\n",
+             frame.name, frame.minMs, frame.avgMs, frame.maxMs, frame.p99Ms, frame.sampleCount);
+    for (uint32_t i = 0; i < engine_system_timing_count(); ++i) {
+        const SystemTimingStats stats = engine_system_timing_stats(i);
+        log_info(MSG_ENGINE, "%-48s min: %7.3fms avg: %7.3fms max: %7.3fms p99: %7.3fms (%u samples)\n",
+                 stats.name, stats.minMs, stats.avgMs, stats.maxMs, stats.p99Ms, stats.sampleCount);
+    }
+}
+
+void engine_set_headless(bool headless) {
+    g_engine->headless = headless;
+}
+
+bool engine_is_headless() {
+    return g_engine->headless;
+}
+
+void engine_set_run_limits(uint64_t maxFrames, double maxSeconds) {
+    g_engine->maxFrames = maxFrames;
+    g_engine->maxSeconds = maxSeconds;
+}
+
+void engine_request_quit() {
+    g_engine->quitRequested = true;
+}
+
+void engine_apply_commandline(int32_t argc, char **argv) {
+    for (int32_t i = 1; i < argc; ++i) {
+        const bool hasValue = i + 1 < argc;
+        if (strcmp(argv[i], "-headless") == 0) {
+            g_engine->headless = true;
+        } else if (strcmp(argv[i], "-frames") == 0 && hasValue) {
+            g_engine->maxFrames = strtoull(argv[++i], nullptr, 10);
+        } else if (strcmp(argv[i], "-seconds") == 0 && hasValue) {
+            g_engine->maxSeconds = strtod(argv[++i], nullptr);
+        }
+    }
+    if (g_engine->headless) {
+        log_info(MSG_ENGINE, "headless: max frames [%llu] max seconds [%f]\n", (unsigned long long) g_engine->maxFrames, g_engine->maxSeconds);
     }
 }
 
 bool engine_is_open() {
-    return window_is_open();
+    if (g_engine->quitRequested) {
+        return false;
+    }
+    if (g_engine->maxFrames > 0 && g_engine->frameCount >= g_engine->maxFrames) {
+        return false;
+    }
+    if (g_engine->maxSeconds > 0.0 && (timer_now_ms() - g_engine->startTimeMs) >= g_engine->maxSeconds * 1000.0) {
+        return false;
+    }
+    return g_engine->headless || window_is_open();
 }
 
 //===init & shutdown=========
 void engine_create() {
-    g_engine = new Engine;
+    g_engine = mem_new<Engine>(MSG_ENGINE);
+    g_engine->startTimeMs = timer_now_ms();
+    profiler_create();
+    BEET_PROFILE_THREAD_NAME("main");
+    engine_job_create();
 }
 
 void engine_cleanup() {
-    delete g_engine;
+    engine_job_cleanup();
+    profiler_cleanup();
+    mem_delete(g_engine);
     g_engine = nullptr;
 }
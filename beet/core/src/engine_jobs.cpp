@@ -0,0 +1,326 @@
+//===defines=================
+#include <core/engine_jobs.h>
+#include <shared/assert.h>
+#include <shared/profiler.h>
+
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+
+//===runtime sizes===========
+// must be a power of two, also the max amount of in-flight jobs a single worker can own.
+#define BEET_JOB_QUEUE_SIZE 4096u
+#define BEET_JOB_QUEUE_MASK (BEET_JOB_QUEUE_SIZE - 1u)
+// parallel for batches live on the waiting threads stack, keep this small enough for nested waits.
+#define BEET_JOB_MAX_PARALLEL_FOR_BATCHES 256u
+#define BEET_JOB_CACHE_LINE_SIZE 64
+
+//===internal structs========
+struct Job {
+    JobFunc func;
+    JobRangeFunc rangeFunc;
+    void *args;
+    uint32_t begin;
+    uint32_t end;
+    JobCounter *counter;
+    std::atomic<bool> pending{false};
+};
+
+// Chase-Lev work-stealing deque, owner pushes & pops from the bottom, thieves steal from the top.
+// https://www.di.ens.fr/~zappa/readings/ppopp13.pdf
+struct JobQueue {
+    alignas(BEET_JOB_CACHE_LINE_SIZE) std::atomic<int64_t> top{0};
+    alignas(BEET_JOB_CACHE_LINE_SIZE) std::atomic<int64_t> bottom{0};
+    std::atomic<Job *> entries[BEET_JOB_QUEUE_SIZE]{};
+};
+
+struct JobWorker {
+    JobQueue queue;
+    Job jobPool[BEET_JOB_QUEUE_SIZE]{};
+    uint32_t jobPoolNext{0};
+    uint32_t stealSeed{0};
+    std::thread thread;
+};
+
+struct JobSystem {
+    JobWorker *workers{};
+    uint32_t workerCount{};
+
+    std::atomic<bool> running{false};
+    std::atomic<uint32_t> queuedJobs{0};
+
+    std::mutex sleepMutex;
+    std::condition_variable sleepCondition;
+};
+
+JobSystem *g_jobSystem;
+
+static thread_local uint32_t s_workerIndex = UINT32_MAX;
+
+//===internal functions======
+static void queue_push(JobQueue &queue, Job *job) {
+    const int64_t bottom = queue.bottom.load(std::memory_order_relaxed);
+    const int64_t top = queue.top.load(std::memory_order_acquire);
+    ASSERT_MSG(bottom - top < (int64_t) BEET_JOB_QUEUE_SIZE, "Err: job queue overflow, exceeded %u in-flight jobs", BEET_JOB_QUEUE_SIZE);
+
+    queue.entries[bottom & BEET_JOB_QUEUE_MASK].store(job, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    queue.bottom.store(bottom + 1, std::memory_order_relaxed);
+}
+
+static Job *queue_pop(JobQueue &queue) {
+    const int64_t bottom = queue.bottom.load(std::memory_order_relaxed) - 1;
+    queue.bottom.store(bottom, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    int64_t top = queue.top.load(std::memory_order_relaxed);
+
+    if (top > bottom) {
+        // queue was already empty
+        queue.bottom.store(bottom + 1, std::memory_order_relaxed);
+        return nullptr;
+    }
+
+    Job *job = queue.entries[bottom & BEET_JOB_QUEUE_MASK].load(std::memory_order_relaxed);
+    if (top == bottom) {
+        // last job in the queue, race any thieves for it.
+        if (!queue.top.compare_exchange_strong(top, top + 1, std::memory_order_seq_cst, std::memory_order_relaxed)) {
+            job = nullptr;
+        }
+        queue.bottom.store(bottom + 1, std::memory_order_relaxed);
+    }
+    return job;
+}
+
+static Job *queue_steal(JobQueue &queue) {
+    int64_t top = queue.top.load(std::memory_order_acquire);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    const int64_t bottom = queue.bottom.load(std::memory_order_acquire);
+
+    if (top >= bottom) {
+        return nullptr;
+    }
+
+    Job *job = queue.entries[top & BEET_JOB_QUEUE_MASK].load(std::memory_order_relaxed);
+    if (!queue.top.compare_exchange_strong(top, top + 1, std::memory_order_seq_cst, std::memory_order_relaxed)) {
+        // lost the race against the owner or another thief.
+        return nullptr;
+    }
+    return job;
+}
+
+static Job *allocate_job(JobWorker &worker) {
+    // ring allocation, slots are only re-used after BEET_JOB_QUEUE_SIZE newer jobs have been allocated by this worker.
+    Job *job = &worker.jobPool[worker.jobPoolNext & BEET_JOB_QUEUE_MASK];
+    ASSERT_MSG(!job->pending.load(std::memory_order_acquire), "Err: job pool exhausted, exceeded %u in-flight jobs", BEET_JOB_QUEUE_SIZE);
+    worker.jobPoolNext++;
+    return job;
+}
+
+static uint32_t next_steal_target(JobWorker &worker) {
+    // xorshift32
+    uint32_t x = worker.stealSeed;
+    x ^= x << 13;
+    x ^= x >> 17;
+    x ^= x << 5;
+    worker.stealSeed = x;
+    return x % g_jobSystem->workerCount;
+}
+
+static Job *find_job(const uint32_t workerIndex) {
+    JobWorker &worker = g_jobSystem->workers[workerIndex];
+    Job *job = queue_pop(worker.queue);
+    if (job == nullptr) {
+        const uint32_t workerCount = g_jobSystem->workerCount;
+        const uint32_t start = next_steal_target(worker);
+        for (uint32_t i = 0; i < workerCount && job == nullptr; ++i) {
+            const uint32_t victim = (start + i) % workerCount;
+            if (victim == workerIndex) {
+                continue;
+            }
+            job = queue_steal(g_jobSystem->workers[victim].queue);
+        }
+    }
+    if (job != nullptr) {
+        g_jobSystem->queuedJobs.fetch_sub(1, std::memory_order_relaxed);
+    }
+    return job;
+}
+
+static void execute_job(Job *job) {
+    if (job->rangeFunc != nullptr) {
+        job->rangeFunc(job->args, job->begin, job->end);
+    } else {
+        job->func(job->args);
+    }
+    // the counter may go out of scope as soon as it hits zero, read it before releasing the job.
+    JobCounter *counter = job->counter;
+    job->pending.store(false, std::memory_order_release);
+    counter->value.fetch_sub(1, std::memory_order_acq_rel);
+}
+
+static void wake_workers(const uint32_t jobCount) {
+    {
+        // sync with workers evaluating their sleep predicate to avoid a lost wakeup.
+        std::lock_guard<std::mutex> lock(g_jobSystem->sleepMutex);
+    }
+    if (jobCount == 1) {
+        g_jobSystem->sleepCondition.notify_one();
+    } else {
+        g_jobSystem->sleepCondition.notify_all();
+    }
+}
+
+static void worker_thread_main(const uint32_t workerIndex) {
+    s_workerIndex = workerIndex;
+    BEET_PROFILE_THREAD_NAME("job worker");
+    while (g_jobSystem->running.load(std::memory_order_acquire)) {
+        Job *job = find_job(workerIndex);
+        if (job != nullptr) {
+            execute_job(job);
+            continue;
+        }
+
+        std::unique_lock<std::mutex> lock(g_jobSystem->sleepMutex);
+        g_jobSystem->sleepCondition.wait(lock, []() {
+            return g_jobSystem->queuedJobs.load(std::memory_order_relaxed) > 0 ||
+                   !g_jobSystem->running.load(std::memory_order_relaxed);
+        });
+    }
+}
+
+static void submit_jobs(Job *const *jobs, uint32_t jobCount, JobCounter *counter) {
+    const uint32_t workerIndex = s_workerIndex;
+    ASSERT_MSG(workerIndex < g_jobSystem->workerCount, "Err: jobs can only be submitted from a job worker thread");
+
+    JobWorker &worker = g_jobSystem->workers[workerIndex];
+    counter->value.fetch_add(jobCount, std::memory_order_relaxed);
+    g_jobSystem->queuedJobs.fetch_add(jobCount, std::memory_order_relaxed);
+    for (uint32_t i = 0; i < jobCount; ++i) {
+        jobs[i]->counter = counter;
+        jobs[i]->pending.store(true, std::memory_order_relaxed);
+        queue_push(worker.queue, jobs[i]);
+    }
+    wake_workers(jobCount);
+}
+
+//===api=====================
+void engine_job_submit(const JobDesc *jobs, uint32_t jobCount, JobCounter *counter) {
+    ASSERT_MSG(s_workerIndex < g_jobSystem->workerCount, "Err: jobs can only be submitted from a job worker thread");
+    JobWorker &worker = g_jobSystem->workers[s_workerIndex];
+
+    const uint32_t maxSubmitCount = 64;
+    Job *submitJobs[maxSubmitCount];
+    for (uint32_t submitted = 0; submitted < jobCount;) {
+        uint32_t submitCount = jobCount - submitted;
+        submitCount = submitCount < maxSubmitCount ? submitCount : maxSubmitCount;
+        for (uint32_t i = 0; i < submitCount; ++i) {
+            const JobDesc &desc = jobs[submitted + i];
+            Job *job = allocate_job(worker);
+            job->func = desc.func;
+            job->rangeFunc = nullptr;
+            job->args = desc.args;
+            job->begin = 0;
+            job->end = 0;
+            submitJobs[i] = job;
+        }
+        submit_jobs(submitJobs, submitCount, counter);
+        submitted += submitCount;
+    }
+}
+
+void engine_job_wait(JobCounter *counter) {
+    const uint32_t workerIndex = s_workerIndex;
+    ASSERT_MSG(workerIndex < g_jobSystem->workerCount, "Err: jobs can only be waited on from a job worker thread");
+
+    // help out instead of blocking, this also keeps nested waits inside of jobs from dead locking.
+    while (counter->value.load(std::memory_order_acquire) > 0) {
+        Job *job = find_job(workerIndex);
+        if (job != nullptr) {
+            execute_job(job);
+        } else {
+            std::this_thread::yield();
+        }
+    }
+}
+
+void engine_job_parallel_for(uint32_t count, uint32_t batchSize, JobRangeFunc func, void *args) {
+    if (count == 0) {
+        return;
+    }
+    if (batchSize == 0) {
+        // aim for a few batches per worker so stealing can even out uneven batches.
+        const uint32_t targetBatches = g_jobSystem->workerCount * 4;
+        batchSize = (count + targetBatches - 1) / targetBatches;
+    }
+    const uint32_t minBatchSize = (count + BEET_JOB_MAX_PARALLEL_FOR_BATCHES - 1) / BEET_JOB_MAX_PARALLEL_FOR_BATCHES;
+    batchSize = batchSize < minBatchSize ? minBatchSize : batchSize;
+    const uint32_t batchCount = (count + batchSize - 1) / batchSize;
+
+    if (batchCount == 1 || g_jobSystem->workerCount == 1) {
+        func(args, 0, count);
+        return;
+    }
+
+    // safe to keep on the stack as we don't return until every batch has finished.
+    Job batchJobs[BEET_JOB_MAX_PARALLEL_FOR_BATCHES];
+    Job *submitJobs[BEET_JOB_MAX_PARALLEL_FOR_BATCHES];
+    for (uint32_t i = 0; i < batchCount; ++i) {
+        const uint32_t begin = i * batchSize;
+        const uint32_t end = begin + batchSize;
+        Job &job = batchJobs[i];
+        job.func = nullptr;
+        job.rangeFunc = func;
+        job.args = args;
+        job.begin = begin;
+        job.end = end < count ? end : count;
+        submitJobs[i] = &job;
+    }
+
+    JobCounter counter{};
+    submit_jobs(submitJobs, batchCount, &counter);
+    engine_job_wait(&counter);
+}
+
+uint32_t engine_job_worker_count() {
+    return g_jobSystem->workerCount;
+}
+
+uint32_t engine_job_worker_index() {
+    return s_workerIndex;
+}
+
+//===init & shutdown=========
+void engine_job_create() {
+    g_jobSystem = new JobSystem;
+
+    // one worker per core, the creating thread acts as worker 0.
+    const uint32_t hardwareThreads = std::thread::hardware_concurrency();
+    g_jobSystem->workerCount = hardwareThreads > 0 ? hardwareThreads : 1;
+    g_jobSystem->workers = new JobWorker[g_jobSystem->workerCount];
+    g_jobSystem->running.store(true, std::memory_order_release);
+
+    for (uint32_t i = 0; i < g_jobSystem->workerCount; ++i) {
+        g_jobSystem->workers[i].stealSeed = 0x9E3779B9u * (i + 1);
+    }
+
+    s_workerIndex = 0;
+    for (uint32_t i = 1; i < g_jobSystem->workerCount; ++i) {
+        g_jobSystem->workers[i].thread = std::thread(worker_thread_main, i);
+    }
+}
+
+void engine_job_cleanup() {
+    g_jobSystem->running.store(false, std::memory_order_release);
+    wake_workers(g_jobSystem->workerCount);
+
+    for (uint32_t i = 1; i < g_jobSystem->workerCount; ++i) {
+        g_jobSystem->workers[i].thread.join();
+    }
+    s_workerIndex = UINT32_MAX;
+
+    delete[] g_jobSystem->workers;
+    g_jobSystem->workers = nullptr;
+
+    delete g_jobSystem;
+    g_jobSystem = nullptr;
+}
@@ -1,6 +1,7 @@
 #include <cstdio>
 
 #include <core/input.h>
+#include <shared/mem_tracker.h>
 
 //===internal structs========
 struct KeyInfo {
@@ -133,13 +134,13 @@ void input_set_scroll_sensitivity(const float sensitivity) {
 
 //===init & shutdown=========
 void input_create() {
-    g_input = new Input{};
+    g_input = mem_new<Input>(MSG_ENGINE);
     input_set_mouse_sensitivity({0.3f, 0.3f});
     input_set_scroll_sensitivity(0.03f);
 }
 
 void input_cleanup() {
-    delete g_input;
+    mem_delete(g_input);
     g_input = nullptr;
 }
 
@@ -1,4 +1,5 @@
 #include <core/time.h>
+#include <shared/mem_tracker.h>
 
 #include <windows.h>
 
@@ -49,7 +50,8 @@ void time_create() {
     QueryPerformanceCounter(&now);
     QueryPerformanceFrequency(&frequency);
 
-    g_time = new Time{
+    g_time = mem_new<Time>(MSG_ENGINE);
+    *g_time = Time{
             (double) now.QuadPart / (double) frequency.QuadPart,
             (double) now.QuadPart / (double) frequency.QuadPart,
             (double) now.QuadPart / (double) frequency.QuadPart,
@@ -61,7 +63,7 @@ void time_create() {
 }
 
 void time_cleanup() {
-    delete g_time;
+    mem_delete(g_time);
     g_time = nullptr;
 }
 
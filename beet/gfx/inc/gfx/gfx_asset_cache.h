@@ -0,0 +1,23 @@
+#ifndef BEETROOT_GFX_ASSET_CACHE_H
+#define BEETROOT_GFX_ASSET_CACHE_H
+
+#include <gfx/gfx_texture.h>
+
+#include <shared/db_types.h>
+
+#include <cstdint>
+
+// textures loaded from disk are shared by path, acquiring a file that is already loaded returns the same db handle.
+// paths are interned & keyed by a 64 bit hash, '\' & '/' are treated as the same separator.
+DbHandle gfx_asset_acquire_texture(const char *path);
+// acquires paths[i] into outHandles[i], everything not already loaded goes through one gfx_create_textures_async.
+void gfx_asset_acquire_textures(const char **paths, uint32_t count, DbHandle *outHandles, GfxParallelFor parallelFor);
+// the texture is destroyed & its db slot freed when the last reference is released.
+void gfx_asset_release_texture(DbHandle handle);
+uint32_t gfx_asset_texture_ref_count(DbHandle handle);
+
+void gfx_create_asset_cache();
+// textures still referenced are left in the db, they're destroyed with the rest of the db textures.
+void gfx_cleanup_asset_cache();
+
+#endif //BEETROOT_GFX_ASSET_CACHE_H
@@ -0,0 +1,20 @@
+#ifndef BEETROOT_GFX_DELETION_QUEUE_H
+#define BEETROOT_GFX_DELETION_QUEUE_H
+
+#include <gfx/gfx_types.h>
+
+//===api=====================
+// queues the resource on the current frame in flight, it's destroyed the next time that frame's graphics fence is waited on.
+// the copy holds the vulkan handles, the caller can free its db slot straight away.
+void gfx_defer_cleanup_mesh(const GfxMesh &mesh);
+void gfx_defer_cleanup_texture(const GfxTexture &texture);
+
+// called once vkGraphicsFences[frameIndex] has signaled, destroys everything queued on that frame.
+void gfx_deletion_queue_flush(uint32_t frameIndex);
+
+//===init & shutdown=========
+void gfx_create_deletion_queue();
+// destroys everything still queued, only call once the device is idle.
+void gfx_cleanup_deletion_queue();
+
+#endif //BEETROOT_GFX_DELETION_QUEUE_H
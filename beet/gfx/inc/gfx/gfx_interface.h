@@ -5,6 +5,8 @@
 
 #include <vulkan/vulkan_core.h>
 
+#include <gfx/gfx_types.h>
+
 //===api=====================
 VkInstance* gfx_instance();
 VkSurfaceKHR* gfx_surface();
@@ -14,7 +16,8 @@ bool gfx_find_supported_validation(const char *layerName);
 
 void gfx_select_physical_device(uint32_t deviceIndex);
 
-void gfx_update(const double& deltaTime);
+// parallelFor spreads the world matrix rebuild across the job system, may be null.
+void gfx_update(const double& deltaTime, GfxParallelFor parallelFor);
 void gfx_sync();
 void gfx_next_frame();
 
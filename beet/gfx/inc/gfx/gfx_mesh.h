@@ -13,6 +13,13 @@ struct RawMesh {
 void gfx_create_cube_immediate(GfxMesh &outMesh);
 void gfx_create_plane_immediate(GfxMesh &outMesh);
 void gfx_create_mesh_immediate(const RawMesh& rawMeshData, GfxMesh &outMesh);
+// uploads on the transfer queue without waiting, the mesh can be drawn straight away.
+// returns a ticket for gfx_upload_is_complete, 0 when it fell back to an immediate upload.
+uint64_t gfx_create_mesh_async(const RawMesh& rawMeshData, GfxMesh &outMesh);
+// built in meshes, vertex & index data point at static arrays.
+RawMesh gfx_cube_raw_mesh();
+RawMesh gfx_plane_raw_mesh();
+// destroys immediately, while frames are in flight use gfx_defer_cleanup_mesh (gfx_deletion_queue.h).
 void gfx_cleanup_mesh(GfxMesh &mesh);
 
 #endif //BEETROOT_GFX_MESH_H
@@ -4,44 +4,93 @@
 #include <shared/db_types.h>
 #include <gfx/gfx_types.h>
 
+#include <math/mat4.h>
+
+// every table is a pool of slots with a free list, removed slots are reused by the next add.
+// handles carry the generation of their slot, accessing a removed or reused slot through an old handle asserts.
+// *_slot_count & *_at_slot iterate the live entries, free slots return nullptr.
+// tables grow in fixed size chunks that never move, pointers from get stay valid until that slot is removed.
+// entities live in the ecs (shared/ecs.h), their components hold handles into these tables.
+// everything is main thread only, except the *_concurrent adds which loaders can call from any thread.
+
+// initial slots per table, every table is carved out of a single allocation made by gfx_db_create.
+struct GfxDbConfig {
+    uint32_t cameras{4};
+    uint32_t transforms{1024};
+    uint32_t uiTransforms{256};
+    uint32_t textures{256};
+    uint32_t meshes{256};
+
+    uint32_t descriptorSets{256};
+
+    uint32_t litMaterials{256};
+    uint32_t fontMaterials{64};
+};
+
 void gfx_db_create();
+void gfx_db_create(const GfxDbConfig &config);
 void gfx_db_cleanup();
 
-uint32_t gfx_db_add_camera(const Camera &camera);
-Camera *gfx_db_get_camera(uint32_t index);
-
-uint32_t gfx_db_add_camera_entity(const CameraEntity &camera);
-CameraEntity *gfx_db_get_camera_entity(uint32_t index);
+DbHandle gfx_db_add_camera(const Camera &camera);
+Camera *gfx_db_get_camera(DbHandle handle);
+void gfx_db_remove_camera(DbHandle handle);
 
-uint32_t gfx_db_add_lit_entity(const LitEntity &litEntity);
-LitEntity *gfx_db_get_lit_entity(uint32_t index);
-uint32_t gfx_db_get_lit_entity_count();
+DbHandle gfx_db_add_lit_material(const LitMaterial &litMaterial);
+LitMaterial *gfx_db_get_lit_material(DbHandle handle);
+void gfx_db_remove_lit_material(DbHandle handle);
 
-uint32_t gfx_db_get_font_entity_count();
-uint32_t gfx_db_add_font_entity(const FontEntity &fontEntity);
-FontEntity *gfx_db_get_font_entity(uint32_t index);
+DbHandle gfx_db_add_font_material(const FontMaterial &fontMaterial);
+FontMaterial *gfx_db_get_font_material(DbHandle handle);
+void gfx_db_remove_font_material(DbHandle handle);
 
-uint32_t gfx_db_add_lit_material(const LitMaterial &litMaterial);
-LitMaterial *gfx_db_get_lit_material(uint32_t index);
+DbHandle gfx_db_add_texture(const GfxTexture &gfxTexture);
+GfxTexture *gfx_db_get_texture(DbHandle handle);
+void gfx_db_remove_texture(DbHandle handle);
+// any thread, takes a fresh slot from the tail & returns its handle straight away.
+// the main thread may use the handle after the next gfx_db_commit_concurrent_adds.
+DbHandle gfx_db_add_texture_concurrent(const GfxTexture &gfxTexture);
+uint32_t gfx_db_get_texture_slot_count();
+GfxTexture *gfx_db_get_texture_at_slot(uint32_t slot);
 
-uint32_t gfx_db_add_font_material(const FontMaterial &fontMaterial);
-FontMaterial *gfx_db_get_font_material(uint32_t index);
+DbHandle gfx_db_add_mesh(const GfxMesh &gfxMesh);
+GfxMesh *gfx_db_get_mesh(DbHandle handle);
+void gfx_db_remove_mesh(DbHandle handle);
+DbHandle gfx_db_add_mesh_concurrent(const GfxMesh &gfxMesh);
+uint32_t gfx_db_get_mesh_slot_count();
+GfxMesh *gfx_db_get_mesh_at_slot(uint32_t slot);
 
-uint32_t gfx_db_add_texture(const GfxTexture &gfxTexture);
-GfxTexture *gfx_db_get_texture(uint32_t index);
-uint32_t gfx_db_get_texture_count();
+// main thread, once per frame. writes concurrent adds that were staged while the tables were full & extends
+// *_slot_count over every concurrent add, returns how many staged adds it wrote.
+uint32_t gfx_db_commit_concurrent_adds();
 
-uint32_t gfx_db_add_mesh(const GfxMesh &gfxMesh);
-GfxMesh *gfx_db_get_mesh(uint32_t index);
-uint32_t gfx_db_get_mesh_count();
+DbHandle gfx_db_add_descriptor_set(const VkDescriptorSet &descriptorSet);
+VkDescriptorSet *gfx_db_get_descriptor_set(DbHandle handle);
+void gfx_db_remove_descriptor_set(DbHandle handle);
 
-uint32_t gfx_db_add_descriptor_set(const VkDescriptorSet &descriptorSet);
-VkDescriptorSet *gfx_db_get_descriptor_set(uint32_t index);
+// transforms are stored as separate component streams, so they are read & written by value.
+// world matrices are cached, gfx_db_update_world_matrices only rebuilds transforms added or set since the last update,
+// along with the children of any transform it rebuilt.
+// returns the number of matrices it rebuilt, sets made after it show up next update.
+DbHandle gfx_db_add_transform(const Transform &transform);
+// adds count transforms to consecutive fresh slots, their handles are written to outHandles in order.
+// parents may be null, otherwise parents[i] is the index of an earlier transform in the batch or UINT32_MAX for a root.
+void gfx_db_add_transforms(const Transform *transforms, const uint32_t *parents, uint32_t count, DbHandle *outHandles);
+Transform gfx_db_get_transform(DbHandle handle);
+void gfx_db_set_transform(DbHandle handle, const Transform &transform);
+void gfx_db_remove_transform(DbHandle handle);
 
-uint32_t gfx_db_add_transform(const Transform &litMaterial);
-Transform *gfx_db_get_transform(uint32_t index);
+// a child's transform is relative to its parent, an invalid parent handle makes the transform a root again.
+// removing a parent turns its children into roots.
+void gfx_db_set_transform_parent(DbHandle handle, DbHandle parentHandle);
+DbHandle gfx_db_get_transform_parent(DbHandle handle);
+const mat4 *gfx_db_get_world_matrix(DbHandle handle);
+// dirty chunks are rebuilt across parallelFor's workers, the parent / child pass runs on the calling thread.
+// a null parallelFor rebuilds everything on the calling thread.
+uint32_t gfx_db_update_world_matrices(GfxParallelFor parallelFor);
 
-uint32_t gfx_db_add_ui_transform(const UiTransform &uiTransform);
-UiTransform *gfx_db_get_ui_transform(uint32_t index);
+DbHandle gfx_db_add_ui_transform(const UiTransform &uiTransform);
+void gfx_db_add_ui_transforms(const UiTransform *uiTransforms, uint32_t count, DbHandle *outHandles);
+UiTransform *gfx_db_get_ui_transform(DbHandle handle);
+void gfx_db_remove_ui_transform(DbHandle handle);
 
 #endif //BEETROOT_GFX_RESOURCE_DB_H
@@ -0,0 +1,41 @@
+#ifndef BEETROOT_GFX_STATS_H
+#define BEETROOT_GFX_STATS_H
+
+#include <cstdint>
+
+struct GfxStats {
+    uint32_t pipelineBinds;
+    uint32_t descriptorSetBinds;
+    uint32_t vertexBufferBinds;
+    uint32_t indexBufferBinds;
+    uint32_t pushConstantUpdates;
+    uint32_t drawCalls;
+    uint64_t indices;
+    uint64_t triangles;
+
+    uint32_t worldMatrixUpdates;
+
+    uint32_t uploads;
+    uint64_t uploadBytes;
+};
+
+//===api=====================
+// counters of the last completed gfx_update, including any uploads issued since the frame before it.
+const GfxStats *gfx_stats();
+
+// counters of the frame currently being recorded.
+GfxStats *gfx_stats_frame();
+void gfx_stats_end_frame();
+
+void gfx_stats_log();
+// logs every frames-th frame as it ends, starting with the first so load time uploads show up. 0 disables it.
+void gfx_stats_set_log_interval(uint32_t frames);
+
+// per heap device memory usage & budget as reported by vma, alongside the host side mem_tracker_log.
+void gfx_stats_log_memory_budgets();
+
+//===init & shutdown=========
+void gfx_create_stats();
+void gfx_cleanup_stats();
+
+#endif //BEETROOT_GFX_STATS_H
@@ -4,6 +4,15 @@
 #include <gfx/gfx_types.h>
 
 void gfx_create_texture_immediate(const char* path, GfxTexture& outTexture);
+// files are read & parsed across parallelFor's workers straight into one staging buffer,
+// then every copy is recorded on the calling thread & uploaded with a single submit.
+// a null parallelFor reads the files on the calling thread.
+void gfx_create_textures_batch(const char** paths, uint32_t count, GfxTexture* outTextures, GfxParallelFor parallelFor);
+// same as the batch above but the copies go to the transfer queue & the cpu doesn't wait for them.
+// the textures can be bound straight away, returns a ticket for gfx_upload_is_complete.
+// falls back to gfx_create_textures_batch & returns 0 without async upload support.
+uint64_t gfx_create_textures_async(const char** paths, uint32_t count, GfxTexture* outTextures, GfxParallelFor parallelFor);
+// destroys immediately, while frames are in flight use gfx_defer_cleanup_texture (gfx_deletion_queue.h).
 void gfx_cleanup_texture(GfxTexture& gfxTexture);
 
 #endif //BEETROOT_GFX_TEXTURE_H
@@ -0,0 +1,30 @@
+#ifndef BEETROOT_GFX_TIMESTAMPS_H
+#define BEETROOT_GFX_TIMESTAMPS_H
+
+#include <vulkan/vulkan_core.h>
+
+enum GfxTimestampPass {
+    LitPass = 0,
+    FontPass = 1,
+
+    PASS_COUNT,
+};
+
+//===api=====================
+// resets this frames query pool, must be recorded outside of a render pass.
+void gfx_timestamps_reset(VkCommandBuffer &cmdBuffer);
+void gfx_timestamps_begin_pass(VkCommandBuffer &cmdBuffer, GfxTimestampPass pass);
+void gfx_timestamps_end_pass(VkCommandBuffer &cmdBuffer, GfxTimestampPass pass);
+
+// reads back the results of the last submission using this frames pool, call once its fence has signaled.
+void gfx_timestamps_collect();
+
+// gpu time of the most recently collected frame, 0 when timestamps are unsupported.
+double gfx_timestamps_pass_ms(GfxTimestampPass pass);
+bool gfx_timestamps_supported();
+
+//===init & shutdown=========
+void gfx_create_timestamps();
+void gfx_cleanup_timestamps();
+
+#endif //BEETROOT_GFX_TIMESTAMPS_H
@@ -10,6 +10,10 @@
 #include <math/vec3.h>
 #include <math/vec2.h>
 
+// same shape as engine_job_parallel_for, gfx doesn't link core so the job system is passed in by the caller.
+typedef void (*GfxRangeFunc)(void *args, uint32_t begin, uint32_t end);
+typedef void (*GfxParallelFor)(uint32_t count, uint32_t batchSize, GfxRangeFunc func, void *args);
+
 struct FontUniformBufferObject {
     mat4 mvp;
     vec2f uvOffset;
@@ -66,8 +70,11 @@ struct GfxDevice {
     uint32_t graphicsQueueIndex{};
     uint32_t presentQueueIndex{};
 
-    VkQueue vkTransferQueue{}; // unused
-    uint32_t transferQueueIndex{}; // unused
+    VkQueue vkTransferQueue{};
+    uint32_t transferQueueIndex{};
+    VkCommandPool vkTransferCommandPool{};
+    // timeline semaphores need vulkan 1.2, without them async uploads fall back to immediate submits.
+    bool supportsTimelineSemaphore{};
 
     VkSwapchainKHR vkSwapchain{};
     VkImageView *vkSwapchainImageViews{};
@@ -91,6 +98,10 @@ struct GfxDevice {
     VkFence vkImmediateFence{};
     VkCommandBuffer vkImmediateCommandBuffer{};
 
+    // one per frame in flight, only read back once the matching graphics fence has signaled.
+    VkQueryPool vkTimestampQueryPools[BEET_VK_COMMAND_BUFFER_COUNT]{};
+    bool timestampQueryPoolWritten[BEET_VK_COMMAND_BUFFER_COUNT]{};
+
     VkDebugUtilsMessengerEXT vkDebugUtilsMessengerExt = VK_NULL_HANDLE;
 };
 
@@ -0,0 +1,65 @@
+#ifndef BEETROOT_GFX_UPLOAD_H
+#define BEETROOT_GFX_UPLOAD_H
+
+#include <gfx/gfx_types.h>
+
+// uploads run on the transfer queue & are tracked by a timeline semaphore, the cpu never waits on them.
+// a resource is usable by any frame recorded after its upload was submitted, that frame's graphics submit waits
+// for the transfer on the gpu & takes queue family ownership before the first render pass.
+
+//===defines=================
+// stages the graphics submit blocks until uploads have finished, uploads are only read as vertices, indices & textures.
+#define GFX_UPLOAD_WAIT_STAGES (VK_PIPELINE_STAGE_VERTEX_INPUT_BIT | VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT)
+// one persistently mapped buffer every upload suballocates its staging memory from.
+#define GFX_STAGING_RING_SIZE (64ull * 1024 * 1024)
+
+//===public structs==========
+// a slice of the staging ring, or a buffer of its own for uploads that don't fit in the ring.
+struct GfxStagingAlloc {
+    VkBuffer buffer;
+    VkDeviceSize offset;
+    VkDeviceSize size;
+    // already offset, points at the start of the slice.
+    void *mapped;
+    // only set for uploads larger than the ring.
+    VmaAllocation dedicatedAllocation;
+};
+
+//===api=====================
+// regions are recycled in allocation order once their upload has finished, blocks only when the ring is full.
+GfxStagingAlloc gfx_staging_alloc(VkDeviceSize size, VkDeviceSize alignment);
+// makes the cpu writes visible to the gpu, call before the copies are submitted.
+void gfx_staging_flush(const GfxStagingAlloc &staging);
+// the region is reused once the upload timeline reaches timelineValue, 0 after an immediate submit has completed.
+// gfx_upload_submit releases its staging itself.
+void gfx_staging_release(const GfxStagingAlloc &staging, uint64_t timelineValue);
+
+// false without timeline semaphore support, callers fall back to immediate uploads.
+bool gfx_upload_async_supported();
+
+// a transfer queue command buffer, barriers recorded into it should use the transfer queue family.
+VkCommandBuffer gfx_upload_begin_recording();
+
+// release barriers hand ownership from the transfer to the graphics queue family, they're recorded into cmd here.
+// the matching acquires are recorded into the next frame, images are expected in TRANSFER_DST_OPTIMAL layout
+// and end up in their newLayout. the staging is released once the transfer has finished.
+// returns a ticket for gfx_upload_is_complete.
+uint64_t gfx_upload_submit(VkCommandBuffer cmd, const GfxStagingAlloc &staging,
+                           const VkImageMemoryBarrier *imageBarriers, uint32_t imageBarrierCount,
+                           const VkBufferMemoryBarrier *bufferBarriers, uint32_t bufferBarrierCount);
+bool gfx_upload_is_complete(uint64_t ticket);
+
+// polls the timeline & recycles staging memory & command buffers of finished uploads, called once per frame.
+void gfx_upload_collect();
+// records the acquires for every upload submitted since the last frame into the frame's command buffer,
+// returns the timeline value its submit has to wait on, 0 when there's nothing to wait for.
+uint64_t gfx_upload_record_acquires(VkCommandBuffer cmd);
+VkSemaphore gfx_upload_timeline();
+
+//===init & shutdown=========
+// also creates the staging ring, call once the allocator exists.
+void gfx_create_upload_queue();
+// waits for uploads still in flight on the transfer queue.
+void gfx_cleanup_upload_queue();
+
+#endif //BEETROOT_GFX_UPLOAD_H
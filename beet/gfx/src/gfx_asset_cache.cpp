@@ -0,0 +1,166 @@
+#include <gfx/gfx_asset_cache.h>
+#include <gfx/gfx_resource_db.h>
+#include <gfx/gfx_texture.h>
+#include <gfx/gfx_deletion_queue.h>
+
+#include <shared/assert.h>
+#include <shared/log.h>
+#include <shared/mem_tracker.h>
+
+#include <cstring>
+#include <functional>
+#include <unordered_map>
+#include <vector>
+
+//===defines=================
+#define ASSET_PATH_HASH_OFFSET 14695981039346656037ull
+#define ASSET_PATH_HASH_PRIME 1099511628211ull
+
+//===internal structs========
+struct AssetEntry {
+    // interned copy of the normalised path, compared on lookup so a hash collision can't alias two files.
+    char *path;
+    DbHandle handle;
+    uint32_t refCount;
+};
+
+template<typename K, typename V>
+using AssetMap = std::unordered_map<K, V, std::hash<K>, std::equal_to<K>, MemAllocator<std::pair<const K, V>, MSG_GFX>>;
+
+struct GfxAssetCache {
+    AssetMap<uint64_t, AssetEntry> texturesByPath;
+    // texture db slot -> path hash, release only has the handle.
+    AssetMap<uint32_t, uint64_t> textureSlotToPath;
+};
+
+GfxAssetCache *g_gfxAssetCache;
+
+//===internal functions======
+static char normalise_path_char(const char c) {
+    return c == '\\' ? '/' : c;
+}
+
+// fnv-1a over the normalised path.
+static uint64_t hash_path(const char *path) {
+    uint64_t hash = ASSET_PATH_HASH_OFFSET;
+    for (const char *c = path; *c != '\0'; ++c) {
+        hash ^= (uint64_t) (unsigned char) normalise_path_char(*c);
+        hash *= ASSET_PATH_HASH_PRIME;
+    }
+    return hash;
+}
+
+static bool path_equals(const char *interned, const char *path) {
+    for (; *interned != '\0' && *path != '\0'; ++interned, ++path) {
+        if (*interned != normalise_path_char(*path)) {
+            return false;
+        }
+    }
+    return *interned == *path;
+}
+
+static char *intern_path(const char *path) {
+    const size_t length = strlen(path);
+    char *interned = (char *) mem_malloc(MSG_GFX, length + 1);
+    for (size_t i = 0; i <= length; ++i) {
+        interned[i] = normalise_path_char(path[i]);
+    }
+    return interned;
+}
+
+static AssetEntry &texture_entry(const DbHandle handle) {
+    const auto slot = g_gfxAssetCache->textureSlotToPath.find(handle.index);
+    ASSERT_MSG(slot != g_gfxAssetCache->textureSlotToPath.end(), "Err: texture [%u:%u] wasn't acquired through the asset cache", handle.index, handle.generation);
+    AssetEntry &entry = g_gfxAssetCache->texturesByPath.at(slot->second);
+    ASSERT_MSG(entry.handle.generation == handle.generation, "Err: stale texture handle [%u:%u]", handle.index, handle.generation);
+    return entry;
+}
+
+static AssetEntry *find_texture(const uint64_t hash, const char *path) {
+    const auto found = g_gfxAssetCache->texturesByPath.find(hash);
+    if (found == g_gfxAssetCache->texturesByPath.end()) {
+        return nullptr;
+    }
+    ASSERT_MSG(path_equals(found->second.path, path), "Err: asset path hash collision between %s and %s", found->second.path, path);
+    return &found->second;
+}
+
+// inserted unreferenced, the acquire that loaded it takes the first reference.
+static void insert_texture(const uint64_t hash, const char *path, const GfxTexture &texture) {
+    AssetEntry entry{};
+    entry.path = intern_path(path);
+    entry.handle = gfx_db_add_texture(texture);
+    entry.refCount = 0;
+    g_gfxAssetCache->texturesByPath.emplace(hash, entry);
+    g_gfxAssetCache->textureSlotToPath[entry.handle.index] = hash;
+    log_verbose(MSG_GFX, "loaded texture %s\n", entry.path);
+}
+
+//===api=====================
+DbHandle gfx_asset_acquire_texture(const char *path) {
+    DbHandle handle{};
+    gfx_asset_acquire_textures(&path, 1, &handle, nullptr);
+    return handle;
+}
+
+void gfx_asset_acquire_textures(const char **paths, uint32_t count, DbHandle *outHandles, GfxParallelFor parallelFor) {
+    std::vector<uint64_t> hashes(count);
+    // paths not loaded yet, a path listed more than once in the batch is only loaded once.
+    std::unordered_map<uint64_t, uint32_t> pending;
+    std::vector<const char *> loadPaths;
+    for (uint32_t i = 0; i < count; ++i) {
+        hashes[i] = hash_path(paths[i]);
+        if (find_texture(hashes[i], paths[i]) == nullptr && pending.emplace(hashes[i], (uint32_t) loadPaths.size()).second) {
+            loadPaths.push_back(paths[i]);
+        }
+    }
+
+    if (!loadPaths.empty()) {
+        std::vector<GfxTexture> textures(loadPaths.size());
+        gfx_create_textures_async(loadPaths.data(), (uint32_t) loadPaths.size(), textures.data(), parallelFor);
+        for (const auto &it: pending) {
+            insert_texture(it.first, loadPaths[it.second], textures[it.second]);
+        }
+    }
+
+    for (uint32_t i = 0; i < count; ++i) {
+        AssetEntry *entry = find_texture(hashes[i], paths[i]);
+        entry->refCount++;
+        outHandles[i] = entry->handle;
+    }
+}
+
+void gfx_asset_release_texture(DbHandle handle) {
+    AssetEntry &entry = texture_entry(handle);
+    ASSERT_MSG(entry.refCount > 0, "Err: texture %s released more often than acquired", entry.path);
+    if (--entry.refCount > 0) {
+        return;
+    }
+
+    log_verbose(MSG_GFX, "unloaded texture %s\n", entry.path);
+    // frames in flight may still sample the texture, it's destroyed once they're done with it.
+    gfx_defer_cleanup_texture(*gfx_db_get_texture(handle));
+    gfx_db_remove_texture(handle);
+
+    const uint64_t hash = g_gfxAssetCache->textureSlotToPath.at(handle.index);
+    g_gfxAssetCache->textureSlotToPath.erase(handle.index);
+    mem_free(entry.path);
+    g_gfxAssetCache->texturesByPath.erase(hash);
+}
+
+uint32_t gfx_asset_texture_ref_count(DbHandle handle) {
+    return texture_entry(handle).refCount;
+}
+
+//===init & shutdown=========
+void gfx_create_asset_cache() {
+    g_gfxAssetCache = mem_new<GfxAssetCache>(MSG_GFX);
+}
+
+void gfx_cleanup_asset_cache() {
+    for (auto &it: g_gfxAssetCache->texturesByPath) {
+        mem_free(it.second.path);
+    }
+    mem_delete(g_gfxAssetCache);
+    g_gfxAssetCache = nullptr;
+}
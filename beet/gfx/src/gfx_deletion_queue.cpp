@@ -0,0 +1,98 @@
+#include <gfx/gfx_deletion_queue.h>
+#include <gfx/gfx_mesh.h>
+#include <gfx/gfx_texture.h>
+
+#include <shared/assert.h>
+#include <shared/mem_tracker.h>
+
+#include <cstring>
+
+extern struct GfxDevice *g_gfxDevice;
+
+//===defines=================
+#define GFX_DELETION_MIN_CAPACITY 16u
+
+//===internal structs========
+template<typename T>
+struct GfxDeletionList {
+    T *items;
+    uint32_t count;
+    uint32_t capacity;
+};
+
+struct GfxDeletionFrame {
+    GfxDeletionList<GfxMesh> meshes;
+    GfxDeletionList<GfxTexture> textures;
+};
+
+struct GfxDeletionQueue {
+    GfxDeletionFrame frames[BEET_VK_COMMAND_BUFFER_COUNT];
+};
+
+GfxDeletionQueue *g_gfxDeletionQueue;
+
+//===internal functions======
+template<typename T>
+static void list_push(GfxDeletionList<T> &list, const T &item) {
+    if (list.count == list.capacity) {
+        const uint32_t capacity = list.capacity > 0 ? list.capacity * 2 : GFX_DELETION_MIN_CAPACITY;
+        T *items = (T *) mem_malloc(MSG_GFX, sizeof(T) * capacity);
+        if (list.items != nullptr) {
+            memcpy(items, list.items, sizeof(T) * list.count);
+            mem_free(list.items);
+        }
+        list.items = items;
+        list.capacity = capacity;
+    }
+    list.items[list.count++] = item;
+}
+
+template<typename T>
+static void list_free(GfxDeletionList<T> &list) {
+    if (list.items != nullptr) {
+        mem_free(list.items);
+    }
+    list = GfxDeletionList<T>{};
+}
+
+static GfxDeletionFrame &current_frame() {
+    ASSERT_MSG(g_gfxDeletionQueue != nullptr, "Err: deletion queue hasn't been created yet");
+    return g_gfxDeletionQueue->frames[g_gfxDevice->nextCommandBufferIndex];
+}
+
+//===api=====================
+void gfx_defer_cleanup_mesh(const GfxMesh &mesh) {
+    list_push(current_frame().meshes, mesh);
+}
+
+void gfx_defer_cleanup_texture(const GfxTexture &texture) {
+    list_push(current_frame().textures, texture);
+}
+
+void gfx_deletion_queue_flush(uint32_t frameIndex) {
+    GfxDeletionFrame &frame = g_gfxDeletionQueue->frames[frameIndex];
+    for (uint32_t i = 0; i < frame.meshes.count; ++i) {
+        gfx_cleanup_mesh(frame.meshes.items[i]);
+    }
+    for (uint32_t i = 0; i < frame.textures.count; ++i) {
+        gfx_cleanup_texture(frame.textures.items[i]);
+    }
+    frame.meshes.count = 0;
+    frame.textures.count = 0;
+}
+
+//===init & shutdown=========
+void gfx_create_deletion_queue() {
+    g_gfxDeletionQueue = mem_new<GfxDeletionQueue>(MSG_GFX);
+    *g_gfxDeletionQueue = GfxDeletionQueue{};
+}
+
+void gfx_cleanup_deletion_queue() {
+    for (uint32_t i = 0; i < BEET_VK_COMMAND_BUFFER_COUNT; ++i) {
+        gfx_deletion_queue_flush(i);
+        list_free(g_gfxDeletionQueue->frames[i].meshes);
+        list_free(g_gfxDeletionQueue->frames[i].textures);
+    }
+    mem_delete(g_gfxDeletionQueue);
+    g_gfxDeletionQueue = nullptr;
+}
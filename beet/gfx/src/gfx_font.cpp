@@ -3,9 +3,13 @@
 #include <gfx/gfx_utils.h>
 #include <gfx/gfx_samplers.h>
 #include <gfx/gfx_resource_db.h>
+#include <gfx/gfx_stats.h>
 
 #include <shared/assert.h>
 #include <shared/log.h>
+#include <shared/profiler.h>
+#include <shared/mem_tracker.h>
+#include <shared/ecs.h>
 
 #include <math/mat4.h>
 #include <math/quat.h>
@@ -47,12 +51,12 @@ struct AtlasInfo {
 };
 
 AtlasInfo *pipeline_load_atlas_info(const std::string &fileSrc) {
-    AtlasInfo *atlasInfo = new AtlasInfo;
+    AtlasInfo *atlasInfo = mem_new<AtlasInfo>(MSG_GFX);
     FILE *fileRead = fopen(fileSrc.c_str(), "rb");
     ASSERT_MSG(fileRead != nullptr, "Err: failed to load atlas info at path: %s ", fileSrc.c_str())
 
     fread(atlasInfo, sizeof(AtlasInfo), 1, fileRead);
-    atlasInfo->glyphs = new GlyphInfo[atlasInfo->glyphCount];
+    atlasInfo->glyphs = mem_new_array<GlyphInfo>(MSG_GFX, atlasInfo->glyphCount);
     fread(&atlasInfo->glyphs[0], sizeof(GlyphInfo) * atlasInfo->glyphCount, 1, fileRead);
 
     fclose(fileRead);
@@ -62,10 +66,11 @@ AtlasInfo *pipeline_load_atlas_info(const std::string &fileSrc) {
 #include <map>
 
 void gfx_font_record_render_pass(VkCommandBuffer &cmdBuffer) {
+    BEET_PROFILE_SCOPE("gfx_font_record_render_pass");
     // get active camera
-//    CameraEntity *camEntity = gfx_db_get_camera_entity(0);
-//    Camera *camera = gfx_db_get_camera(camEntity->cameraIndex);
-//    Transform *camTransform = gfx_db_get_transform(camEntity->transformIndex);
+//    const Entity camEntity = ecs_first<CameraComponent>();
+//    Camera *camera = gfx_db_get_camera(ecs_get<CameraComponent>(camEntity)->cameraHandle);
+//    const Transform camTransform = gfx_db_get_transform(ecs_get<TransformComponent>(camEntity)->transformHandle);
 //
 //    auto camForward = quat(camTransform->rotation) * WORLD_FORWARD;
 //    vec3f lookTarget = camTransform->position + camForward;
@@ -114,18 +119,20 @@ void gfx_font_record_render_pass(VkCommandBuffer &cmdBuffer) {
     renderPassBeginInfo.clearValueCount = clearValueCount;
     renderPassBeginInfo.pClearValues = clearValues;
 
+    GfxStats *stats = gfx_stats_frame();
     vkCmdBeginRenderPass(cmdBuffer, &renderPassBeginInfo, VK_SUBPASS_CONTENTS_INLINE);
     {
-        const uint32_t litEntityCount = gfx_db_get_lit_entity_count();
-        for (uint32_t i = 0; i < litEntityCount; ++i) {
-            const FontEntity *entity = gfx_db_get_font_entity(i);
-            const FontMaterial *material = gfx_db_get_font_material(entity->materialIndex);
-            const VkDescriptorSet *descriptorSet = gfx_db_get_descriptor_set(material->descriptorSetIndex);
-            const UiTransform *transform = gfx_db_get_ui_transform(entity->uiTransformIndex);
-            const GfxMesh *mesh = gfx_db_get_mesh(entity->meshIndex);
+        ecs_each<UiTransformComponent, MeshComponent, FontMaterialComponent>([&](Entity, const UiTransformComponent &uiTransform, const MeshComponent &meshComponent,
+                                                                                 const FontMaterialComponent &materialComponent) {
+            const FontMaterial *material = gfx_db_get_font_material(materialComponent.materialHandle);
+            const VkDescriptorSet *descriptorSet = gfx_db_get_descriptor_set(material->descriptorSetHandle);
+            const UiTransform *transform = gfx_db_get_ui_transform(uiTransform.uiTransformHandle);
+            const GfxMesh *mesh = gfx_db_get_mesh(meshComponent.meshHandle);
 
             vkCmdBindPipeline(cmdBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, g_vulkanFont.pipeline);
             vkCmdBindDescriptorSets(cmdBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, g_vulkanFont.pipelineLayout, 0, 1, descriptorSet, 0, nullptr);
+            stats->pipelineBinds++;
+            stats->descriptorSetBinds++;
 
             const vec3f pos = {transform->position, 0};
             const vec3f rot = {transform->rotation, 0};
@@ -140,6 +147,7 @@ void gfx_font_record_render_pass(VkCommandBuffer &cmdBuffer) {
             ubo.uvOffset = uvOffset;
             ubo.uvScale = uvScale;
             vkCmdPushConstants(cmdBuffer, g_vulkanFont.pipelineLayout, VK_SHADER_STAGE_ALL, 0, sizeof(FontUniformBufferObject), &ubo);
+            stats->pushConstantUpdates++;
 
             const VkBuffer vertexBuffers[] = {mesh->vertexBuffer};
             const VkDeviceSize offsets[] = {0};
@@ -147,7 +155,12 @@ void gfx_font_record_render_pass(VkCommandBuffer &cmdBuffer) {
 
             vkCmdBindIndexBuffer(cmdBuffer, mesh->indexBuffer, 0, VK_INDEX_TYPE_UINT32);
             vkCmdDrawIndexed(cmdBuffer, mesh->indexCount, 1, 0, 0, 0);
-        }
+            stats->vertexBufferBinds++;
+            stats->indexBufferBinds++;
+            stats->drawCalls++;
+            stats->indices += mesh->indexCount;
+            stats->triangles += mesh->indexCount / 3;
+        });
     }
     vkCmdEndRenderPass(cmdBuffer);
 }
@@ -3,9 +3,12 @@
 #include <gfx/gfx_utils.h>
 #include <gfx/gfx_samplers.h>
 #include <gfx/gfx_resource_db.h>
+#include <gfx/gfx_stats.h>
 
 #include <shared/assert.h>
 #include <shared/log.h>
+#include <shared/profiler.h>
+#include <shared/ecs.h>
 
 #include <math/mat4.h>
 #include <math/quat.h>
@@ -28,15 +31,17 @@ static VulkanLit g_vulkanLit; // questionable static alloc should move to ptr cr
 extern struct GfxDevice *g_gfxDevice;
 
 void gfx_lit_record_render_pass(VkCommandBuffer &cmdBuffer) {
+    BEET_PROFILE_SCOPE("gfx_lit_record_render_pass");
     // get active camera
-    CameraEntity *camEntity = gfx_db_get_camera_entity(0);
-    Camera *camera = gfx_db_get_camera(camEntity->cameraIndex);
-    Transform *camTransform = gfx_db_get_transform(camEntity->transformIndex);
+    const Entity camEntity = ecs_first<CameraComponent>();
+    ASSERT_MSG(camEntity.generation != ECS_INVALID_GENERATION, "Err: no active camera entity");
+    Camera *camera = gfx_db_get_camera(ecs_get<CameraComponent>(camEntity)->cameraHandle);
+    const Transform camTransform = gfx_db_get_transform(ecs_get<TransformComponent>(camEntity)->transformHandle);
 
-    auto camForward = quat(camTransform->rotation) * WORLD_FORWARD;
-    vec3f lookTarget = camTransform->position + camForward;
+    auto camForward = quat(camTransform.rotation) * WORLD_FORWARD;
+    vec3f lookTarget = camTransform.position + camForward;
 
-    mat4 view = lookAt(camTransform->position, lookTarget, WORLD_UP);
+    mat4 view = lookAt(camTransform.position, lookTarget, WORLD_UP);
     mat4 proj = perspective(as_radians(camera->fov), (float) g_gfxDevice->vkExtent.width / (float) g_gfxDevice->vkExtent.height, camera->zNear,
                             camera->zFar);
     proj[1][1] *= -1;
@@ -58,23 +63,25 @@ void gfx_lit_record_render_pass(VkCommandBuffer &cmdBuffer) {
     renderPassBeginInfo.clearValueCount = clearValueCount;
     renderPassBeginInfo.pClearValues = clearValues;
 
+    GfxStats *stats = gfx_stats_frame();
     vkCmdBeginRenderPass(cmdBuffer, &renderPassBeginInfo, VK_SUBPASS_CONTENTS_INLINE);
     {
-        const uint32_t litEntityCount = gfx_db_get_lit_entity_count();
-        for (uint32_t i = 0; i < litEntityCount; ++i) {
-            const LitEntity *entity = gfx_db_get_lit_entity(i);
-            const LitMaterial *material = gfx_db_get_lit_material(entity->materialIndex);
-            const VkDescriptorSet *descriptorSet = gfx_db_get_descriptor_set(material->descriptorSetIndex);
-            const Transform *transform = gfx_db_get_transform(entity->transformIndex);
-            const GfxMesh *mesh = gfx_db_get_mesh(entity->meshIndex);
+        ecs_each<TransformComponent, MeshComponent, LitMaterialComponent>([&](Entity, const TransformComponent &transform, const MeshComponent &meshComponent,
+                                                                              const LitMaterialComponent &materialComponent) {
+            const LitMaterial *material = gfx_db_get_lit_material(materialComponent.materialHandle);
+            const VkDescriptorSet *descriptorSet = gfx_db_get_descriptor_set(material->descriptorSetHandle);
+            const mat4 *model = gfx_db_get_world_matrix(transform.transformHandle);
+            const GfxMesh *mesh = gfx_db_get_mesh(meshComponent.meshHandle);
 
 
             vkCmdBindPipeline(cmdBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, g_vulkanLit.pipeline);
             vkCmdBindDescriptorSets(cmdBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, g_vulkanLit.pipelineLayout, 0, 1, descriptorSet, 0, nullptr);
+            stats->pipelineBinds++;
+            stats->descriptorSetBinds++;
 
-            const mat4 model = translate(mat4(1.0f), transform->position) * toMat4(quat(transform->rotation)) * scale(mat4(1.0f), transform->scale);
-            const UniformBufferObject ubo = {viewProj * model};
+            const UniformBufferObject ubo = {viewProj * *model};
             vkCmdPushConstants(cmdBuffer, g_vulkanLit.pipelineLayout, VK_SHADER_STAGE_VERTEX_BIT, 0, sizeof(UniformBufferObject), &ubo);
+            stats->pushConstantUpdates++;
 
             const VkBuffer vertexBuffers[] = {mesh->vertexBuffer};
             const VkDeviceSize offsets[] = {0};
@@ -82,7 +89,12 @@ void gfx_lit_record_render_pass(VkCommandBuffer &cmdBuffer) {
 
             vkCmdBindIndexBuffer(cmdBuffer, mesh->indexBuffer, 0, VK_INDEX_TYPE_UINT32);
             vkCmdDrawIndexed(cmdBuffer, mesh->indexCount, 1, 0, 0, 0);
-        }
+            stats->vertexBufferBinds++;
+            stats->indexBufferBinds++;
+            stats->drawCalls++;
+            stats->indices += mesh->indexCount;
+            stats->triangles += mesh->indexCount / 3;
+        });
     }
     vkCmdEndRenderPass(cmdBuffer);
 }
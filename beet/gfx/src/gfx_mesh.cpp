@@ -1,11 +1,13 @@
 #include <gfx/gfx_mesh.h>
 #include <gfx/gfx_command.h>
+#include <gfx/gfx_stats.h>
+#include <gfx/gfx_upload.h>
 
 #include <shared/assert.h>
 
 extern struct GfxDevice *g_gfxDevice;
 
-void gfx_create_plane_immediate(GfxMesh &outMesh) {
+RawMesh gfx_plane_raw_mesh() {
     const uint32_t vertexCount = 4;
     static Vertex vertices[vertexCount] = {
             //===POS================//===COLOUR===========//===UV===
@@ -25,10 +27,10 @@ void gfx_create_plane_immediate(GfxMesh &outMesh) {
     rawMesh.vertexData = vertices;
     rawMesh.indexSize = indexCount;
     rawMesh.indexData = indices;
-    gfx_create_mesh_immediate(rawMesh, outMesh);
+    return rawMesh;
 }
 
-void gfx_create_cube_immediate(GfxMesh &outMesh) {
+RawMesh gfx_cube_raw_mesh() {
     const uint32_t vertexCount = 24;
     static Vertex vertices[vertexCount] = {
             //===POS================//===COLOUR===========//===UV===
@@ -78,129 +80,116 @@ void gfx_create_cube_immediate(GfxMesh &outMesh) {
     rawMesh.vertexData = vertices;
     rawMesh.indexSize = indexCount;
     rawMesh.indexData = indices;
-    gfx_create_mesh_immediate(rawMesh, outMesh);
+    return rawMesh;
 }
 
-void gfx_create_mesh_immediate(const RawMesh& rawMesh, GfxMesh &outMesh) {
-    ASSERT_MSG(g_gfxDevice->vmaAllocator, "Err: vma allocator hasn't been created yet");
+void gfx_create_plane_immediate(GfxMesh &outMesh) {
+    gfx_create_mesh_immediate(gfx_plane_raw_mesh(), outMesh);
+}
 
-    const uint32_t vertexCount = rawMesh.vertexSize;
-    const uint32_t indexCount = rawMesh.indexSize;
-    Vertex* vertices = rawMesh.vertexData;
-    uint32_t* indices = rawMesh.indexData;
+void gfx_create_cube_immediate(GfxMesh &outMesh) {
+    gfx_create_mesh_immediate(gfx_cube_raw_mesh(), outMesh);
+}
 
+// vertices & indices share one staging slice, indices start straight after the vertices.
+static GfxStagingAlloc stage_mesh(const RawMesh &rawMesh) {
+    const VkDeviceSize vertexBufferSize = sizeof(Vertex) * rawMesh.vertexSize;
+    const VkDeviceSize indexBufferSize = sizeof(uint32_t) * rawMesh.indexSize;
+    GfxStagingAlloc staging = gfx_staging_alloc(vertexBufferSize + indexBufferSize, sizeof(uint32_t));
+    memcpy(staging.mapped, rawMesh.vertexData, vertexBufferSize);
+    memcpy((unsigned char *) staging.mapped + vertexBufferSize, rawMesh.indexData, indexBufferSize);
+    gfx_staging_flush(staging);
+    gfx_stats_frame()->uploads += 2;
+    gfx_stats_frame()->uploadBytes += staging.size;
+    return staging;
+}
 
-    size_t vertexBufferSize = sizeof(Vertex) * vertexCount;
-    size_t indexBufferSize = sizeof(uint32_t ) * indexCount;
-    outMesh.indexCount = indexCount;
+static void create_mesh_buffers(const RawMesh &rawMesh, GfxMesh &outMesh) {
+    outMesh.indexCount = rawMesh.indexSize;
 
-    // Create vertex buffer
+    VmaAllocationCreateInfo bufferAllocCreateInfo = {};
+    bufferAllocCreateInfo.usage = VMA_MEMORY_USAGE_AUTO;
 
     VkBufferCreateInfo vbInfo = {VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO};
-    vbInfo.size = vertexBufferSize;
-    vbInfo.usage = VK_BUFFER_USAGE_TRANSFER_SRC_BIT;
-    vbInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
-
-    VmaAllocationCreateInfo vbAllocCreateInfo = {};
-    vbAllocCreateInfo.usage = VMA_MEMORY_USAGE_AUTO;
-    vbAllocCreateInfo.flags = VMA_ALLOCATION_CREATE_HOST_ACCESS_SEQUENTIAL_WRITE_BIT | VMA_ALLOCATION_CREATE_MAPPED_BIT;
-
-    VkBuffer stagingVertexBuffer = VK_NULL_HANDLE;
-    VmaAllocation stagingVertexBufferAlloc = VK_NULL_HANDLE;
-    VmaAllocationInfo stagingVertexBufferAllocInfo = {};
-    VkResult vertexStagingRes = vmaCreateBuffer(
-            g_gfxDevice->vmaAllocator,
-            &vbInfo, &vbAllocCreateInfo,
-            &stagingVertexBuffer,
-            &stagingVertexBufferAlloc,
-            &stagingVertexBufferAllocInfo
-    );
-    ASSERT_MSG(vertexStagingRes == VK_SUCCESS, "Err: failed to create staging vertex buffer");
-
-    memcpy(stagingVertexBufferAllocInfo.pMappedData, vertices, vertexBufferSize);
-
+    vbInfo.size = sizeof(Vertex) * rawMesh.vertexSize;
     vbInfo.usage = VK_BUFFER_USAGE_TRANSFER_DST_BIT | VK_BUFFER_USAGE_VERTEX_BUFFER_BIT;
-    vbAllocCreateInfo.flags = 0;
+    vbInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
     VkResult vertexBufferRes = vmaCreateBuffer(
             g_gfxDevice->vmaAllocator,
             &vbInfo,
-            &vbAllocCreateInfo,
+            &bufferAllocCreateInfo,
             &outMesh.vertexBuffer,
             &outMesh.vertexAllocation,
             nullptr
     );
     ASSERT_MSG(vertexBufferRes == VK_SUCCESS, "Err: failed to create vertex buffer");
-    // Create index buffer
 
     VkBufferCreateInfo ibInfo = {VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO};
-    ibInfo.size = indexBufferSize;
-    ibInfo.usage = VK_BUFFER_USAGE_TRANSFER_SRC_BIT;
-    ibInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
-
-    VmaAllocationCreateInfo ibAllocCreateInfo = {};
-    ibAllocCreateInfo.usage = VMA_MEMORY_USAGE_AUTO;
-    ibAllocCreateInfo.flags = VMA_ALLOCATION_CREATE_HOST_ACCESS_SEQUENTIAL_WRITE_BIT | VMA_ALLOCATION_CREATE_MAPPED_BIT;
-
-    VkBuffer stagingIndexBuffer = VK_NULL_HANDLE;
-    VmaAllocation stagingIndexBufferAlloc = VK_NULL_HANDLE;
-    VmaAllocationInfo stagingIndexBufferAllocInfo = {};
-    VkResult stagingIndexBufferRes = vmaCreateBuffer(
-            g_gfxDevice->vmaAllocator,
-            &ibInfo,
-            &ibAllocCreateInfo,
-            &stagingIndexBuffer,
-            &stagingIndexBufferAlloc,
-            &stagingIndexBufferAllocInfo
-    );
-    ASSERT_MSG(stagingIndexBufferRes == VK_SUCCESS, "Err: failed to create index staging buffer");
-    memcpy(stagingIndexBufferAllocInfo.pMappedData, indices, indexBufferSize);
-
-    // No need to flush stagingIndexBuffer memory because CPU_ONLY memory is always HOST_COHERENT.
-
+    ibInfo.size = sizeof(uint32_t) * rawMesh.indexSize;
     ibInfo.usage = VK_BUFFER_USAGE_TRANSFER_DST_BIT | VK_BUFFER_USAGE_INDEX_BUFFER_BIT;
-    ibAllocCreateInfo.flags = 0;
+    ibInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
     VkResult indexBufferRes = vmaCreateBuffer(
             g_gfxDevice->vmaAllocator,
             &ibInfo,
-            &ibAllocCreateInfo,
+            &bufferAllocCreateInfo,
             &outMesh.indexBuffer,
             &outMesh.indexAllocation,
             nullptr
     );
-    ASSERT_MSG(indexBufferRes == VK_SUCCESS, "Err: failed to create index staging buffer");
+    ASSERT_MSG(indexBufferRes == VK_SUCCESS, "Err: failed to create index buffer");
+}
+
+static void record_mesh_copies(VkCommandBuffer cmd, const GfxStagingAlloc &staging, const RawMesh &rawMesh, const GfxMesh &mesh) {
+    const VkDeviceSize vertexBufferSize = sizeof(Vertex) * rawMesh.vertexSize;
+
+    VkBufferCopy vbCopyRegion = {};
+    vbCopyRegion.srcOffset = staging.offset;
+    vbCopyRegion.size = vertexBufferSize;
+    vkCmdCopyBuffer(cmd, staging.buffer, mesh.vertexBuffer, 1, &vbCopyRegion);
+
+    VkBufferCopy ibCopyRegion = {};
+    ibCopyRegion.srcOffset = staging.offset + vertexBufferSize;
+    ibCopyRegion.size = sizeof(uint32_t) * rawMesh.indexSize;
+    vkCmdCopyBuffer(cmd, staging.buffer, mesh.indexBuffer, 1, &ibCopyRegion);
+}
 
-    // Copy buffers
+void gfx_create_mesh_immediate(const RawMesh& rawMesh, GfxMesh &outMesh) {
+    ASSERT_MSG(g_gfxDevice->vmaAllocator, "Err: vma allocator hasn't been created yet");
+
+    const GfxStagingAlloc staging = stage_mesh(rawMesh);
+    create_mesh_buffers(rawMesh, outMesh);
 
     gfx_command_begin_immediate_recording();
-    {
-        VkBufferCopy vbCopyRegion = {};
-        vbCopyRegion.srcOffset = 0;
-        vbCopyRegion.dstOffset = 0;
-        vbCopyRegion.size = vbInfo.size;
-        vkCmdCopyBuffer(
-                g_gfxDevice->vkImmediateCommandBuffer,
-                stagingVertexBuffer,
-                outMesh.vertexBuffer,
-                1,
-                &vbCopyRegion
-        );
-
-        VkBufferCopy ibCopyRegion = {};
-        ibCopyRegion.srcOffset = 0;
-        ibCopyRegion.dstOffset = 0;
-        ibCopyRegion.size = ibInfo.size;
-        vkCmdCopyBuffer(
-                g_gfxDevice->vkImmediateCommandBuffer,
-                stagingIndexBuffer,
-                outMesh.indexBuffer,
-                1,
-                &ibCopyRegion
-        );
-    }
+    record_mesh_copies(g_gfxDevice->vkImmediateCommandBuffer, staging, rawMesh, outMesh);
     gfx_command_end_immediate_recording();
 
-    vmaDestroyBuffer(g_gfxDevice->vmaAllocator, stagingIndexBuffer, stagingIndexBufferAlloc);
-    vmaDestroyBuffer(g_gfxDevice->vmaAllocator, stagingVertexBuffer, stagingVertexBufferAlloc);
+    // the immediate submit has already waited for the copies.
+    gfx_staging_release(staging, 0);
+}
+
+uint64_t gfx_create_mesh_async(const RawMesh &rawMesh, GfxMesh &outMesh) {
+    if (!gfx_upload_async_supported()) {
+        gfx_create_mesh_immediate(rawMesh, outMesh);
+        return 0;
+    }
+    ASSERT_MSG(g_gfxDevice->vmaAllocator, "Err: vma allocator hasn't been created yet");
+
+    const GfxStagingAlloc staging = stage_mesh(rawMesh);
+    create_mesh_buffers(rawMesh, outMesh);
+
+    VkCommandBuffer cmd = gfx_upload_begin_recording();
+    record_mesh_copies(cmd, staging, rawMesh, outMesh);
+
+    VkBufferMemoryBarrier barriers[2] = {};
+    barriers[0].sType = VK_STRUCTURE_TYPE_BUFFER_MEMORY_BARRIER;
+    barriers[0].buffer = outMesh.vertexBuffer;
+    barriers[0].size = VK_WHOLE_SIZE;
+    barriers[0].dstAccessMask = VK_ACCESS_VERTEX_ATTRIBUTE_READ_BIT;
+    barriers[1].sType = VK_STRUCTURE_TYPE_BUFFER_MEMORY_BARRIER;
+    barriers[1].buffer = outMesh.indexBuffer;
+    barriers[1].size = VK_WHOLE_SIZE;
+    barriers[1].dstAccessMask = VK_ACCESS_INDEX_READ_BIT;
+    return gfx_upload_submit(cmd, staging, nullptr, 0, barriers, 2);
 }
 
 void gfx_cleanup_mesh(GfxMesh &mesh) {
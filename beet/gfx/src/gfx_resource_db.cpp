@@ -3,224 +3,800 @@
 
 #include <shared/db_types.h>
 #include <shared/assert.h>
+#include <shared/log.h>
+#include <shared/arena.h>
+#include <shared/mem_tracker.h>
+#include <shared/profiler.h>
+#include <shared/bit_utils.h>
+
+#include <math/transform_batch.h>
+
+#include <algorithm>
+#include <atomic>
+#include <cstring>
+#include <new>
+
+//===defines=================
+// slots per chunk, power of two so a slot resolves to its chunk with a shift & mask.
+#define DB_CHUNK_SHIFT 8u
+#define DB_CHUNK_SIZE (1u << DB_CHUNK_SHIFT)
+#define DB_CHUNK_MASK (DB_CHUNK_SIZE - 1u)
+
+// growth chunks are small, batch them into larger arena blocks.
+#define DB_ARENA_MIN_BLOCK_SIZE (256u * 1024u)
+
+// stored in DbChunk::nextFree, any other value is the next slot in the free list.
+#define DB_SLOT_ALIVE UINT32_MAX
+#define DB_SLOT_NONE (UINT32_MAX - 1u)
+
+// transform dirty bits per word, a chunk holds DB_CHUNK_SIZE / DB_DIRTY_BITS words.
+#define DB_DIRTY_BITS 64u
+
+//===internal structs========
+// item storage of one or more consecutive chunks, tables default to an array of structs.
+template<typename T>
+struct DbItems {
+    T *items;
+
+    static size_t bytes(const uint32_t slots) {
+        return sizeof(T) * slots + 16;
+    }
+
+    static DbItems alloc(Arena &arena, const uint32_t slots) {
+        DbItems storage{arena_alloc_array<T>(arena, slots)};
+        for (uint32_t i = 0; i < slots; ++i) {
+            new(&storage.items[i]) T();
+        }
+        return storage;
+    }
+
+    DbItems offset(const uint32_t slot) const {
+        return DbItems{items + slot};
+    }
+
+    void store(const uint32_t local, const T &item) {
+        items[local] = item;
+    }
+};
+
+// transforms are kept as one stream per component so the local matrices can be built in a single batch.
+// every write sets the slot's dirty bit, only dirty transforms get their local matrix rebuilt.
+// world matrices of roots are their local matrix, children are composed with their parent's world matrix.
+template<>
+struct DbItems<Transform> {
+    float *positionX;
+    float *positionY;
+    float *positionZ;
+    float *rotationX;
+    float *rotationY;
+    float *rotationZ;
+    float *scaleX;
+    float *scaleY;
+    float *scaleZ;
+    mat4 *localMatrices;
+    mat4 *worldMatrices;
+    uint64_t *dirty;
+
+    // parent slot or DB_SLOT_NONE for roots.
+    uint32_t *parents;
+    uint32_t *childCounts;
+    // update that last changed the world matrix, children compare against their parent's.
+    uint32_t *worldVersions;
+
+    static size_t bytes(const uint32_t slots) {
+        return (sizeof(float) * 9 + sizeof(mat4) * 2 + sizeof(uint32_t) * 3) * slots + sizeof(uint64_t) * (slots / DB_DIRTY_BITS) + 16 * 15;
+    }
+
+    static DbItems alloc(Arena &arena, const uint32_t slots) {
+        DbItems storage{};
+        float **streams[] = {
+                &storage.positionX, &storage.positionY, &storage.positionZ,
+                &storage.rotationX, &storage.rotationY, &storage.rotationZ,
+                &storage.scaleX, &storage.scaleY, &storage.scaleZ,
+        };
+        for (float **stream: streams) {
+            *stream = arena_alloc_array<float>(arena, slots);
+        }
+        storage.localMatrices = arena_alloc_array<mat4>(arena, slots);
+        storage.worldMatrices = arena_alloc_array<mat4>(arena, slots);
+        storage.dirty = arena_alloc_array<uint64_t>(arena, slots / DB_DIRTY_BITS);
+        storage.parents = arena_alloc_array<uint32_t>(arena, slots);
+        storage.childCounts = arena_alloc_array<uint32_t>(arena, slots);
+        storage.worldVersions = arena_alloc_array<uint32_t>(arena, slots);
+        for (uint32_t i = 0; i < slots; ++i) {
+            storage.store(i, Transform{});
+            storage.localMatrices[i] = mat4(1.0f);
+            storage.worldMatrices[i] = mat4(1.0f);
+            storage.parents[i] = DB_SLOT_NONE;
+            storage.childCounts[i] = 0;
+            storage.worldVersions[i] = 0;
+        }
+        // the identity matrix already matches the default transform.
+        memset(storage.dirty, 0, sizeof(uint64_t) * (slots / DB_DIRTY_BITS));
+        return storage;
+    }
+
+    DbItems offset(const uint32_t slot) const {
+        return DbItems{
+                positionX + slot, positionY + slot, positionZ + slot,
+                rotationX + slot, rotationY + slot, rotationZ + slot,
+                scaleX + slot, scaleY + slot, scaleZ + slot,
+                localMatrices + slot,
+                worldMatrices + slot,
+                dirty + slot / DB_DIRTY_BITS,
+                parents + slot,
+                childCounts + slot,
+                worldVersions + slot,
+        };
+    }
+
+    void mark_dirty(const uint32_t local) {
+        dirty[local / DB_DIRTY_BITS] |= 1ull << (local % DB_DIRTY_BITS);
+    }
+
+    void store(const uint32_t local, const Transform &transform) {
+        positionX[local] = transform.position.x;
+        positionY[local] = transform.position.y;
+        positionZ[local] = transform.position.z;
+        rotationX[local] = transform.rotation.x;
+        rotationY[local] = transform.rotation.y;
+        rotationZ[local] = transform.rotation.z;
+        scaleX[local] = transform.scale.x;
+        scaleY[local] = transform.scale.y;
+        scaleZ[local] = transform.scale.z;
+        mark_dirty(local);
+    }
+
+    Transform load(const uint32_t local) const {
+        return Transform{
+                {positionX[local], positionY[local], positionZ[local]},
+                {rotationX[local], rotationY[local], rotationZ[local]},
+                {scaleX[local], scaleY[local], scaleZ[local]},
+        };
+    }
+};
+
+// transforms that have a parent, sorted by depth so a single pass composes every parent before its children.
+struct TransformHierarchy {
+    // depth << 32 | slot, sorting the keys orders by depth & keeps siblings in slot order.
+    uint64_t *order;
+    uint32_t count;
+    uint32_t capacity;
+    // set whenever a parent changes, the order is rebuilt by the next world matrix update.
+    bool dirty;
+    uint32_t version;
+};
+
+template<typename T>
+struct DbChunk {
+    DbItems<T> items;
+    uint32_t *generations;
+    // DB_SLOT_ALIVE is stored with release once the item is written, readers on the main thread acquire it.
+    std::atomic<uint32_t> *nextFree;
+};
+
+// concurrent add that didn't fit the capacity at the time, written into its reserved slot by the next commit.
+template<typename T>
+struct DbStaged {
+    DbStaged *next;
+    uint32_t slot;
+    T item;
+};
+
+template<typename T>
+struct DbPool {
+    // main thread view of the chunk table.
+    DbChunk<T> *chunks;
+    uint32_t chunkCount;
+    uint32_t chunkCapacity;
+
+    // slots visible to the main thread, iteration never needs to look past this.
+    uint32_t slotCount;
+    uint32_t freeHead;
+
+    // tail slots are reserved with a fetch_add by both the main thread & concurrent adds.
+    std::atomic<uint32_t> reservedCount;
+    // published by the main thread after it grows, chunk tables are never freed so a stale table stays usable.
+    std::atomic<DbChunk<T> *> sharedChunks;
+    std::atomic<uint32_t> sharedCapacity;
+    std::atomic<DbStaged<T> *> staged;
+
+    const char *name;
+};
+
+struct GfxResourceDb {
+    Arena arena;
+
+    DbPool<Camera> cameras;
+    DbPool<Transform> transforms;
+    TransformHierarchy transformHierarchy;
+    DbPool<UiTransform> uiTransforms;
+    DbPool<GfxTexture> textures;
+    DbPool<GfxMesh> meshes;
+
+    DbPool<VkDescriptorSet> descriptorSets;
+
+    DbPool<LitMaterial> litMaterials;
+    DbPool<FontMaterial> fontMaterials;
+};
+
+// chunks own their dirty bits & matrices, so each one is rebuilt by a single worker without locking.
+struct WorldMatrixRebuild {
+    const DbPool<Transform> *pool;
+    uint32_t version;
+    std::atomic<uint32_t> updated;
+};
+
+GfxResourceDb *g_gfxResourceDb = nullptr;
+
+//===internal functions======
+static uint32_t chunks_for_slots(const uint32_t slots) {
+    return (slots + DB_CHUNK_SIZE - 1) >> DB_CHUNK_SHIFT;
+}
 
-static CameraEntity s_dbCameraEntities[MAX_DB_CAMERA_ENTITIES];
-static uint32_t s_dbCameraEntitiesCount{0};
+static uint32_t chunk_table_capacity(const uint32_t chunkCount) {
+    return chunkCount * 2 > 8 ? chunkCount * 2 : 8;
+}
 
-static LitEntity s_dbLitEntities[MAX_DB_LIT_ENTITIES];
-static uint32_t s_dbLitEntitiesCount{0};
+// upper bound of the arena bytes pool_create takes, 16 bytes of alignment slack per allocation.
+template<typename T>
+static size_t pool_create_bytes(const uint32_t capacity) {
+    const uint32_t slots = chunks_for_slots(capacity) * DB_CHUNK_SIZE;
+    return sizeof(DbChunk<T>) * chunk_table_capacity(chunks_for_slots(capacity))
+           + DbItems<T>::bytes(slots)
+           + (sizeof(uint32_t) + sizeof(std::atomic<uint32_t>)) * slots
+           + 16 * 3;
+}
 
-static FontEntity s_dbFontEntities[MAX_DB_FONT_ENTITIES];
-static uint32_t s_dbFontEntitiesCount{0};
+template<typename T>
+static void chunks_init(DbPool<T> &pool, Arena &arena, const uint32_t chunkCount) {
+    const uint32_t slots = chunkCount * DB_CHUNK_SIZE;
+    const DbItems<T> items = DbItems<T>::alloc(arena, slots);
+    uint32_t *generations = arena_alloc_array<uint32_t>(arena, slots);
+    std::atomic<uint32_t> *nextFree = arena_alloc_array<std::atomic<uint32_t>>(arena, slots);
+    for (uint32_t i = 0; i < slots; ++i) {
+        generations[i] = DB_INVALID_GENERATION + 1;
+        new(&nextFree[i]) std::atomic<uint32_t>(DB_SLOT_NONE);
+    }
+    for (uint32_t i = 0; i < chunkCount; ++i) {
+        DbChunk<T> &chunk = pool.chunks[pool.chunkCount++];
+        chunk.items = items.offset(i * DB_CHUNK_SIZE);
+        chunk.generations = generations + i * DB_CHUNK_SIZE;
+        chunk.nextFree = nextFree + i * DB_CHUNK_SIZE;
+    }
+    // the table before the capacity, a concurrent add that sees the new capacity also sees a table that covers it.
+    pool.sharedChunks.store(pool.chunks, std::memory_order_release);
+    pool.sharedCapacity.store(pool.chunkCount * DB_CHUNK_SIZE, std::memory_order_release);
+}
 
-static Camera s_dbCameras[MAX_DB_CAMERAS];
-static uint32_t s_dbCameraCount{0};
+// initial chunks share one allocation per array, so iterating the initial capacity walks contiguous memory.
+template<typename T>
+static void pool_create(DbPool<T> &pool, Arena &arena, const uint32_t capacity, const char *name) {
+    pool.chunkCapacity = chunk_table_capacity(chunks_for_slots(capacity));
+    pool.chunks = arena_alloc_array<DbChunk<T>>(arena, pool.chunkCapacity);
+    pool.chunkCount = 0;
+    pool.slotCount = 0;
+    pool.freeHead = DB_SLOT_NONE;
+    pool.reservedCount.store(0, std::memory_order_relaxed);
+    pool.staged.store(nullptr, std::memory_order_relaxed);
+    pool.name = name;
+    chunks_init(pool, arena, chunks_for_slots(capacity));
+}
 
-static Transform s_dbTransforms[MAX_DB_TRANSFORMS];
-static uint32_t s_dbTransformsCount{0};
+// chunks added by the same grow share one allocation per array.
+template<typename T>
+static void pool_grow(DbPool<T> &pool, Arena &arena, const uint32_t chunkCount = 1) {
+    if (pool.chunkCount + chunkCount > pool.chunkCapacity) {
+        // only the chunk table moves, the chunks it points to stay put.
+        const uint32_t newCapacity = pool.chunkCount + chunkCount > pool.chunkCapacity * 2 ? pool.chunkCount + chunkCount : pool.chunkCapacity * 2;
+        DbChunk<T> *chunks = arena_alloc_array<DbChunk<T>>(arena, newCapacity);
+        memcpy(chunks, pool.chunks, sizeof(DbChunk<T>) * pool.chunkCount);
+        pool.chunks = chunks;
+        pool.chunkCapacity = newCapacity;
+    }
+    chunks_init(pool, arena, chunkCount);
+    log_verbose(MSG_GFX, "grew %s to %u slots\n", pool.name, pool.chunkCount * DB_CHUNK_SIZE);
+}
 
-static UiTransform s_dbUiTransforms[MAX_DB_UI_TRANSFORMS];
-static uint32_t s_dbUiTransformsCount{0};
+template<typename T>
+static DbHandle pool_add(DbPool<T> &pool, const T &item) {
+    uint32_t slot;
+    if (pool.freeHead != DB_SLOT_NONE) {
+        slot = pool.freeHead;
+        pool.freeHead = pool.chunks[slot >> DB_CHUNK_SHIFT].nextFree[slot & DB_CHUNK_MASK].load(std::memory_order_relaxed);
+    } else {
+        slot = pool.reservedCount.fetch_add(1, std::memory_order_relaxed);
+        // concurrent adds may have reserved past the capacity as well, grow until this slot is covered.
+        if (slot >= pool.chunkCount * DB_CHUNK_SIZE) {
+            pool_grow(pool, g_gfxResourceDb->arena, chunks_for_slots(slot + 1) - pool.chunkCount);
+        }
+        pool.slotCount = slot + 1 > pool.slotCount ? slot + 1 : pool.slotCount;
+    }
+    DbChunk<T> &chunk = pool.chunks[slot >> DB_CHUNK_SHIFT];
+    chunk.items.store(slot & DB_CHUNK_MASK, item);
+    chunk.nextFree[slot & DB_CHUNK_MASK].store(DB_SLOT_ALIVE, std::memory_order_release);
+    return DbHandle{slot, chunk.generations[slot & DB_CHUNK_MASK]};
+}
 
-static GfxTexture s_dbTextures[MAX_DB_GFX_TEXTURES];
-static uint32_t s_dbTexturesCount{0};
+// takes count consecutive fresh slots from the tail, handles are written in the same order as the items.
+template<typename T>
+static uint32_t pool_add_range(DbPool<T> &pool, const T *items, const uint32_t count, DbHandle *outHandles) {
+    const uint32_t first = pool.reservedCount.fetch_add(count, std::memory_order_relaxed);
+    if (first + count > pool.chunkCount * DB_CHUNK_SIZE) {
+        pool_grow(pool, g_gfxResourceDb->arena, chunks_for_slots(first + count) - pool.chunkCount);
+    }
+    for (uint32_t i = 0; i < count; ++i) {
+        const uint32_t slot = first + i;
+        DbChunk<T> &chunk = pool.chunks[slot >> DB_CHUNK_SHIFT];
+        chunk.items.store(slot & DB_CHUNK_MASK, items[i]);
+        chunk.nextFree[slot & DB_CHUNK_MASK].store(DB_SLOT_ALIVE, std::memory_order_release);
+        outHandles[i] = DbHandle{slot, chunk.generations[slot & DB_CHUNK_MASK]};
+    }
+    pool.slotCount = first + count > pool.slotCount ? first + count : pool.slotCount;
+    return first;
+}
 
-static GfxMesh s_dbMeshes[MAX_DB_GFX_MESHES];
-static uint32_t s_dbMeshesCount{0};
+// any thread, only ever takes fresh slots from the tail so it never races the main thread's free list.
+template<typename T>
+static DbHandle pool_add_concurrent(DbPool<T> &pool, const T &item) {
+    const uint32_t slot = pool.reservedCount.fetch_add(1, std::memory_order_relaxed);
+    // tail slots have never been handed out, they are still at their first generation.
+    const DbHandle handle{slot, DB_INVALID_GENERATION + 1};
+    if (slot < pool.sharedCapacity.load(std::memory_order_acquire)) {
+        DbChunk<T> &chunk = pool.sharedChunks.load(std::memory_order_acquire)[slot >> DB_CHUNK_SHIFT];
+        chunk.items.store(slot & DB_CHUNK_MASK, item);
+        chunk.nextFree[slot & DB_CHUNK_MASK].store(DB_SLOT_ALIVE, std::memory_order_release);
+        return handle;
+    }
+
+    // only the main thread grows the pool, stage the item until the next commit.
+    DbStaged<T> *staged = mem_new<DbStaged<T>>(MSG_GFX);
+    staged->slot = slot;
+    staged->item = item;
+    staged->next = pool.staged.load(std::memory_order_relaxed);
+    while (!pool.staged.compare_exchange_weak(staged->next, staged, std::memory_order_release, std::memory_order_relaxed)) {
+    }
+    return handle;
+}
 
-static VkDescriptorSet s_dbDescriptorSet[MAX_DB_VK_DESCRIPTOR_SETS];
-static uint32_t s_dbDescriptorSetCount{0};
+template<typename T>
+static uint32_t pool_commit(DbPool<T> &pool) {
+    DbStaged<T> *staged = pool.staged.exchange(nullptr, std::memory_order_acquire);
+    const uint32_t reservedCount = pool.reservedCount.load(std::memory_order_relaxed);
+    if (reservedCount > pool.chunkCount * DB_CHUNK_SIZE) {
+        pool_grow(pool, g_gfxResourceDb->arena, chunks_for_slots(reservedCount) - pool.chunkCount);
+    }
+
+    uint32_t committed = 0;
+    while (staged != nullptr) {
+        DbChunk<T> &chunk = pool.chunks[staged->slot >> DB_CHUNK_SHIFT];
+        chunk.items.store(staged->slot & DB_CHUNK_MASK, staged->item);
+        chunk.nextFree[staged->slot & DB_CHUNK_MASK].store(DB_SLOT_ALIVE, std::memory_order_release);
+        DbStaged<T> *next = staged->next;
+        mem_delete(staged);
+        staged = next;
+        committed++;
+    }
+    // reserved slots that are still being written stay hidden until their alive marker is stored.
+    pool.slotCount = reservedCount > pool.slotCount ? reservedCount : pool.slotCount;
+    return committed;
+}
 
-static LitMaterial s_dbLitMaterials[MAX_DB_LIT_MATERIALS];
-static uint32_t s_dbLitMaterialsCount{0};
+template<typename T>
+static void pool_cleanup(DbPool<T> &pool) {
+    DbStaged<T> *staged = pool.staged.exchange(nullptr, std::memory_order_acquire);
+    while (staged != nullptr) {
+        DbStaged<T> *next = staged->next;
+        mem_delete(staged);
+        staged = next;
+    }
+}
 
-static FontMaterial s_dbFontMaterials[MAX_DB_FONT_MATERIALS];
-static uint32_t s_dbFontMaterialsCount{0};
+// asserts the handle refers to a live slot & returns the chunk holding it.
+template<typename T>
+static DbChunk<T> &pool_validate(DbPool<T> &pool, const DbHandle handle) {
+    ASSERT_MSG(handle.index < pool.chunkCount * DB_CHUNK_SIZE, "Err: invalid %s handle index %u, capacity [%u]", pool.name, handle.index, pool.chunkCount * DB_CHUNK_SIZE);
+    DbChunk<T> &chunk = pool.chunks[handle.index >> DB_CHUNK_SHIFT];
+    const uint32_t local = handle.index & DB_CHUNK_MASK;
+    ASSERT_MSG(chunk.nextFree[local].load(std::memory_order_acquire) == DB_SLOT_ALIVE && chunk.generations[local] == handle.generation,
+               "Err: stale %s handle [%u:%u], slot is at generation %u", pool.name, handle.index, handle.generation, chunk.generations[local]);
+    return chunk;
+}
 
+template<typename T>
+static T *pool_get(DbPool<T> &pool, const DbHandle handle) {
+    return &pool_validate(pool, handle).items.items[handle.index & DB_CHUNK_MASK];
+}
+
+template<typename T>
+static void pool_remove(DbPool<T> &pool, const DbHandle handle) {
+    DbChunk<T> &chunk = pool_validate(pool, handle);
+    const uint32_t local = handle.index & DB_CHUNK_MASK;
+    chunk.items.store(local, T{});
+    chunk.generations[local]++;
+    if (chunk.generations[local] == DB_INVALID_GENERATION) {
+        chunk.generations[local]++;
+    }
+    chunk.nextFree[local].store(pool.freeHead, std::memory_order_relaxed);
+    pool.freeHead = handle.index;
+}
+
+template<typename T>
+static T *pool_at_slot(DbPool<T> &pool, const uint32_t slot) {
+    if (slot >= pool.slotCount) {
+        return nullptr;
+    }
+    DbChunk<T> &chunk = pool.chunks[slot >> DB_CHUNK_SHIFT];
+    if (chunk.nextFree[slot & DB_CHUNK_MASK].load(std::memory_order_acquire) != DB_SLOT_ALIVE) {
+        return nullptr;
+    }
+    return &chunk.items.items[slot & DB_CHUNK_MASK];
+}
+
+static DbItems<Transform> &transform_items(const uint32_t slot) {
+    return g_gfxResourceDb->transforms.chunks[slot >> DB_CHUNK_SHIFT].items;
+}
+
+static void transform_detach(const uint32_t slot) {
+    DbItems<Transform> &items = transform_items(slot);
+    const uint32_t local = slot & DB_CHUNK_MASK;
+    if (items.parents[local] == DB_SLOT_NONE) {
+        return;
+    }
+    transform_items(items.parents[local]).childCounts[items.parents[local] & DB_CHUNK_MASK]--;
+    items.parents[local] = DB_SLOT_NONE;
+    items.mark_dirty(local);
+    g_gfxResourceDb->transformHierarchy.dirty = true;
+}
+
+static void transform_hierarchy_rebuild(TransformHierarchy &hierarchy, const DbPool<Transform> &pool) {
+    hierarchy.count = 0;
+    for (uint32_t slot = 0; slot < pool.slotCount; ++slot) {
+        if (transform_items(slot).parents[slot & DB_CHUNK_MASK] == DB_SLOT_NONE) {
+            continue;
+        }
+        if (hierarchy.count == hierarchy.capacity) {
+            const uint32_t capacity = hierarchy.capacity * 2 > 64 ? hierarchy.capacity * 2 : 64;
+            uint64_t *order = (uint64_t *) mem_malloc(MSG_GFX, sizeof(uint64_t) * capacity);
+            if (hierarchy.order != nullptr) {
+                memcpy(order, hierarchy.order, sizeof(uint64_t) * hierarchy.count);
+                mem_free(hierarchy.order);
+            }
+            hierarchy.order = order;
+            hierarchy.capacity = capacity;
+        }
+        // walking up to the root only happens here, on updates after a parent changed.
+        uint64_t depth = 0;
+        for (uint32_t parent = transform_items(slot).parents[slot & DB_CHUNK_MASK]; parent != DB_SLOT_NONE;
+             parent = transform_items(parent).parents[parent & DB_CHUNK_MASK]) {
+            depth++;
+        }
+        hierarchy.order[hierarchy.count++] = depth << 32 | slot;
+    }
+    std::sort(hierarchy.order, hierarchy.order + hierarchy.count);
+    hierarchy.dirty = false;
+}
+
+static void rebuild_world_matrix_chunks(void *args, uint32_t begin, uint32_t end) {
+    WorldMatrixRebuild &rebuild = *(WorldMatrixRebuild *) args;
+    uint32_t updated = 0;
+    for (uint32_t i = begin; i < end; ++i) {
+        const DbItems<Transform> &items = rebuild.pool->chunks[i].items;
+        for (uint32_t word = 0; word < DB_CHUNK_SIZE / DB_DIRTY_BITS; ++word) {
+            const uint64_t bits = items.dirty[word];
+            if (bits == 0) {
+                continue;
+            }
+            items.dirty[word] = 0;
+
+            // rebuild the span between the first & last dirty bit, clean transforms inside it come out unchanged.
+            const uint32_t first = word * DB_DIRTY_BITS + lowest_set_bit(bits);
+            const uint32_t last = word * DB_DIRTY_BITS + highest_set_bit(bits);
+            const DbItems<Transform> span = items.offset(first);
+            const TransformStreams streams{
+                    span.positionX, span.positionY, span.positionZ,
+                    span.rotationX, span.rotationY, span.rotationZ,
+                    span.scaleX, span.scaleY, span.scaleZ,
+            };
+            transform_batch_world_matrices(streams, last - first + 1, span.localMatrices);
+            updated += last - first + 1;
+
+            // roots take their local matrix as is, children are composed below once their parent is up to date.
+            for (uint64_t remaining = bits; remaining != 0; remaining &= remaining - 1) {
+                const uint32_t local = word * DB_DIRTY_BITS + lowest_set_bit(remaining);
+                items.worldVersions[local] = rebuild.version;
+                if (items.parents[local] == DB_SLOT_NONE) {
+                    items.worldMatrices[local] = items.localMatrices[local];
+                }
+            }
+        }
+    }
+    rebuild.updated.fetch_add(updated, std::memory_order_relaxed);
+}
+
+//===init & shutdown=========
 void gfx_db_create() {
-    memset(s_dbCameraEntities, 0, sizeof(CameraEntity) * MAX_DB_CAMERA_ENTITIES);
-    memset(s_dbLitEntities, 0, sizeof(LitEntity) * MAX_DB_LIT_ENTITIES);
-    memset(s_dbFontEntities, 0, sizeof(FontEntity) * MAX_DB_FONT_ENTITIES);
+    gfx_db_create(GfxDbConfig{});
+}
+
+void gfx_db_create(const GfxDbConfig &config) {
+    ASSERT_MSG(g_gfxResourceDb == nullptr, "Err: gfx db has already been created");
+    g_gfxResourceDb = mem_new<GfxResourceDb>(MSG_GFX);
+
+    const size_t initialBytes = pool_create_bytes<Camera>(config.cameras)
+                                + pool_create_bytes<Transform>(config.transforms)
+                                + pool_create_bytes<UiTransform>(config.uiTransforms)
+                                + pool_create_bytes<GfxTexture>(config.textures)
+                                + pool_create_bytes<GfxMesh>(config.meshes)
+                                + pool_create_bytes<VkDescriptorSet>(config.descriptorSets)
+                                + pool_create_bytes<LitMaterial>(config.litMaterials)
+                                + pool_create_bytes<FontMaterial>(config.fontMaterials);
 
-    memset(s_dbCameras, 0, sizeof(Camera) * MAX_DB_CAMERAS);
-    memset(s_dbTransforms, 0, sizeof(Transform) * MAX_DB_TRANSFORMS);
-    memset(s_dbUiTransforms, 0, sizeof(UiTransform) * MAX_DB_UI_TRANSFORMS);
-    memset(s_dbTextures, 0, sizeof(GfxTexture) * MAX_DB_GFX_TEXTURES);
-    memset(s_dbMeshes, 0, sizeof(GfxMesh) * MAX_DB_GFX_MESHES);
+    Arena &arena = g_gfxResourceDb->arena;
+    arena_create(arena, initialBytes, DB_ARENA_MIN_BLOCK_SIZE, MSG_GFX);
 
-    memset(s_dbDescriptorSet, 0, sizeof(VkDescriptorSet) * MAX_DB_VK_DESCRIPTOR_SETS);
+    pool_create(g_gfxResourceDb->cameras, arena, config.cameras, "camera");
+    pool_create(g_gfxResourceDb->transforms, arena, config.transforms, "transform");
+    g_gfxResourceDb->transformHierarchy = TransformHierarchy{nullptr, 0, 0, false, 0};
+    pool_create(g_gfxResourceDb->uiTransforms, arena, config.uiTransforms, "ui transform");
+    pool_create(g_gfxResourceDb->textures, arena, config.textures, "gfx texture");
+    pool_create(g_gfxResourceDb->meshes, arena, config.meshes, "gfx mesh");
 
-    memset(s_dbLitMaterials, 0, sizeof(LitMaterial) * MAX_DB_LIT_MATERIALS);
-    memset(s_dbFontMaterials, 0, sizeof(FontMaterial) * MAX_DB_FONT_MATERIALS);
+    pool_create(g_gfxResourceDb->descriptorSets, arena, config.descriptorSets, "vk descriptor set");
+
+    pool_create(g_gfxResourceDb->litMaterials, arena, config.litMaterials, "lit material");
+    pool_create(g_gfxResourceDb->fontMaterials, arena, config.fontMaterials, "font material");
+
+    ASSERT_MSG(arena_block_count(arena) == 1, "Err: gfx db initial size estimate was too small");
+}
+
+void gfx_db_cleanup() {
+    if (g_gfxResourceDb == nullptr) {
+        return;
+    }
+    pool_cleanup(g_gfxResourceDb->textures);
+    pool_cleanup(g_gfxResourceDb->meshes);
+    if (g_gfxResourceDb->transformHierarchy.order != nullptr) {
+        mem_free(g_gfxResourceDb->transformHierarchy.order);
+    }
+    arena_cleanup(g_gfxResourceDb->arena);
+    mem_delete(g_gfxResourceDb);
+    g_gfxResourceDb = nullptr;
+}
+
+//===api=====================
+DbHandle gfx_db_add_camera(const Camera &camera) {
+    return pool_add(g_gfxResourceDb->cameras, camera);
+}
+
+Camera *gfx_db_get_camera(DbHandle handle) {
+    return pool_get(g_gfxResourceDb->cameras, handle);
+}
+
+void gfx_db_remove_camera(DbHandle handle) {
+    pool_remove(g_gfxResourceDb->cameras, handle);
+}
+
+DbHandle gfx_db_add_lit_material(const LitMaterial &litMaterial) {
+    return pool_add(g_gfxResourceDb->litMaterials, litMaterial);
+}
+
+LitMaterial *gfx_db_get_lit_material(DbHandle handle) {
+    return pool_get(g_gfxResourceDb->litMaterials, handle);
 }
 
-void gfx_db_cleanup() {}
+void gfx_db_remove_lit_material(DbHandle handle) {
+    pool_remove(g_gfxResourceDb->litMaterials, handle);
+}
+
+DbHandle gfx_db_add_font_material(const FontMaterial &fontMaterial) {
+    return pool_add(g_gfxResourceDb->fontMaterials, fontMaterial);
+}
+
+FontMaterial *gfx_db_get_font_material(DbHandle handle) {
+    return pool_get(g_gfxResourceDb->fontMaterials, handle);
+}
+
+void gfx_db_remove_font_material(DbHandle handle) {
+    pool_remove(g_gfxResourceDb->fontMaterials, handle);
+}
 
-uint32_t gfx_db_add_camera(const Camera &camera) {
-    ASSERT_MSG(s_dbCameraCount < MAX_DB_CAMERAS, "Err: exceeded pre-allocated amount of cameras %u, max amount [%u]", s_dbCameraCount, MAX_DB_CAMERAS);
-    uint32_t currentCameraIndex = s_dbCameraCount;
-    s_dbCameras[currentCameraIndex] = camera;
-    s_dbCameraCount++;
-    return currentCameraIndex;
+DbHandle gfx_db_add_texture(const GfxTexture &gfxTexture) {
+    return pool_add(g_gfxResourceDb->textures, gfxTexture);
 }
 
-Camera *gfx_db_get_camera(uint32_t index) {
-    ASSERT_MSG(index < MAX_DB_CAMERAS, "Err: invalid db index %u, max index [%u]", index, MAX_DB_CAMERAS);
-    return &s_dbCameras[index];
+GfxTexture *gfx_db_get_texture(DbHandle handle) {
+    return pool_get(g_gfxResourceDb->textures, handle);
 }
 
-uint32_t gfx_db_add_camera_entity(const CameraEntity &camera) {
-    ASSERT_MSG(s_dbCameraEntitiesCount < MAX_DB_CAMERA_ENTITIES, "Err: exceeded pre-allocated amount of cameras %u, max amount [%u]",
-               s_dbCameraEntitiesCount, MAX_DB_CAMERA_ENTITIES);
-    uint32_t currentCameraEntityIndex = s_dbCameraEntitiesCount;
-    s_dbCameraEntities[currentCameraEntityIndex] = camera;
-    s_dbCameraEntitiesCount++;
-    return currentCameraEntityIndex;
+void gfx_db_remove_texture(DbHandle handle) {
+    pool_remove(g_gfxResourceDb->textures, handle);
 }
 
-CameraEntity *gfx_db_get_camera_entity(uint32_t index) {
-    ASSERT_MSG(index < MAX_DB_CAMERA_ENTITIES, "Err: invalid db index %u, max index [%u]", index, MAX_DB_CAMERA_ENTITIES);
-    return &s_dbCameraEntities[index];
+DbHandle gfx_db_add_texture_concurrent(const GfxTexture &gfxTexture) {
+    return pool_add_concurrent(g_gfxResourceDb->textures, gfxTexture);
 }
 
-uint32_t gfx_db_get_lit_entity_count() {
-    return s_dbLitEntitiesCount;
+uint32_t gfx_db_get_texture_slot_count() {
+    return g_gfxResourceDb->textures.slotCount;
 }
 
-uint32_t gfx_db_add_lit_entity(const LitEntity &litEntity) {
-    ASSERT_MSG(s_dbLitEntitiesCount < MAX_DB_LIT_ENTITIES, "Err: exceeded pre-allocated amount of lit entities %u, max amount [%u]",
-               s_dbLitEntitiesCount, MAX_DB_LIT_ENTITIES);
-    uint32_t currentLitEntityIndex = s_dbLitEntitiesCount;
-    s_dbLitEntities[currentLitEntityIndex] = litEntity;
-    s_dbLitEntitiesCount++;
-    return currentLitEntityIndex;
+GfxTexture *gfx_db_get_texture_at_slot(uint32_t slot) {
+    return pool_at_slot(g_gfxResourceDb->textures, slot);
 }
 
-LitEntity *gfx_db_get_lit_entity(uint32_t index) {
-    ASSERT_MSG(index < MAX_DB_LIT_ENTITIES, "Err: invalid db index %u, max index [%u]", index, MAX_DB_LIT_ENTITIES);
-    return &s_dbLitEntities[index];
+DbHandle gfx_db_add_mesh(const GfxMesh &gfxMesh) {
+    return pool_add(g_gfxResourceDb->meshes, gfxMesh);
 }
 
-uint32_t gfx_db_get_font_entity_count() {
-    return s_dbFontEntitiesCount;
+GfxMesh *gfx_db_get_mesh(DbHandle handle) {
+    return pool_get(g_gfxResourceDb->meshes, handle);
 }
 
-uint32_t gfx_db_add_font_entity(const FontEntity &fontEntity) {
-    ASSERT_MSG(s_dbFontEntitiesCount < MAX_DB_FONT_ENTITIES, "Err: exceeded pre-allocated amount of font entities %u, max amount [%u]",
-               s_dbFontEntitiesCount, MAX_DB_FONT_ENTITIES);
-    uint32_t currentFontEntityIndex = s_dbFontEntitiesCount;
-    s_dbFontEntities[currentFontEntityIndex] = fontEntity;
-    s_dbFontEntitiesCount++;
-    return currentFontEntityIndex;
+void gfx_db_remove_mesh(DbHandle handle) {
+    pool_remove(g_gfxResourceDb->meshes, handle);
 }
 
-FontEntity *gfx_db_get_font_entity(uint32_t index) {
-    ASSERT_MSG(index < MAX_DB_FONT_ENTITIES, "Err: invalid db index %u, max index [%u]", index, MAX_DB_FONT_ENTITIES);
-    return &s_dbFontEntities[index];
+DbHandle gfx_db_add_mesh_concurrent(const GfxMesh &gfxMesh) {
+    return pool_add_concurrent(g_gfxResourceDb->meshes, gfxMesh);
 }
 
-uint32_t gfx_db_get_texture_count() {
-    return s_dbTexturesCount;
+uint32_t gfx_db_get_mesh_slot_count() {
+    return g_gfxResourceDb->meshes.slotCount;
 }
 
-uint32_t gfx_db_add_texture(const GfxTexture &gfxTexture) {
-    ASSERT_MSG(s_dbTexturesCount < MAX_DB_GFX_TEXTURES, "Err: exceeded pre-allocated amount of gfx textures %u, max amount [%u]",
-               s_dbTexturesCount, MAX_DB_GFX_TEXTURES);
-    uint32_t currentGfxTextureIndex = s_dbTexturesCount;
-    s_dbTextures[currentGfxTextureIndex] = gfxTexture;
-    s_dbTexturesCount++;
-    return currentGfxTextureIndex;
+GfxMesh *gfx_db_get_mesh_at_slot(uint32_t slot) {
+    return pool_at_slot(g_gfxResourceDb->meshes, slot);
 }
 
-GfxTexture *gfx_db_get_texture(uint32_t index) {
-    ASSERT_MSG(index < MAX_DB_GFX_TEXTURES, "Err: invalid db index %u, max index [%u]", index, MAX_DB_GFX_TEXTURES);
-    return &s_dbTextures[index];
+DbHandle gfx_db_add_descriptor_set(const VkDescriptorSet &descriptorSet) {
+    return pool_add(g_gfxResourceDb->descriptorSets, descriptorSet);
 }
 
-uint32_t gfx_db_get_mesh_count() {
-    return s_dbMeshesCount;
+VkDescriptorSet *gfx_db_get_descriptor_set(DbHandle handle) {
+    return pool_get(g_gfxResourceDb->descriptorSets, handle);
 }
 
-uint32_t gfx_db_add_mesh(const GfxMesh &gfxMesh) {
-    ASSERT_MSG(s_dbMeshesCount < MAX_DB_GFX_MESHES, "Err: exceeded pre-allocated amount of gfx meshes %u, max amount [%u]",
-               s_dbMeshesCount, MAX_DB_GFX_MESHES);
-    uint32_t currentGfxTextureIndex = s_dbMeshesCount;
-    s_dbMeshes[currentGfxTextureIndex] = gfxMesh;
-    s_dbMeshesCount++;
-    return currentGfxTextureIndex;
+void gfx_db_remove_descriptor_set(DbHandle handle) {
+    pool_remove(g_gfxResourceDb->descriptorSets, handle);
 }
 
-GfxMesh *gfx_db_get_mesh(uint32_t index) {
-    ASSERT_MSG(index < MAX_DB_GFX_MESHES, "Err: invalid db index %u, max index [%u]", index, MAX_DB_GFX_MESHES);
-    return &s_dbMeshes[index];
+DbHandle gfx_db_add_transform(const Transform &transform) {
+    return pool_add(g_gfxResourceDb->transforms, transform);
 }
 
-uint32_t gfx_db_add_descriptor_set(const VkDescriptorSet &descriptorSet) {
-    ASSERT_MSG(s_dbDescriptorSetCount < MAX_DB_VK_DESCRIPTOR_SETS, "Err: exceeded pre-allocated amount of vk descriptor sets %u, max amount [%u]",
-               s_dbDescriptorSetCount, MAX_DB_VK_DESCRIPTOR_SETS);
-    uint32_t currentDescriptorSetIndex = s_dbDescriptorSetCount;
-    s_dbDescriptorSet[currentDescriptorSetIndex] = descriptorSet;
-    s_dbDescriptorSetCount++;
-    return currentDescriptorSetIndex;
+void gfx_db_add_transforms(const Transform *transforms, const uint32_t *parents, uint32_t count, DbHandle *outHandles) {
+    const uint32_t first = pool_add_range(g_gfxResourceDb->transforms, transforms, count, outHandles);
+    if (parents == nullptr) {
+        return;
+    }
+    for (uint32_t i = 0; i < count; ++i) {
+        if (parents[i] == UINT32_MAX) {
+            continue;
+        }
+        // parents always come first, so a batch can't contain a cycle.
+        ASSERT_MSG(parents[i] < i, "Err: transform %u of a batch has parent %u, parents must come before their children", i, parents[i]);
+        const uint32_t slot = first + i;
+        const uint32_t parent = first + parents[i];
+        transform_items(slot).parents[slot & DB_CHUNK_MASK] = parent;
+        transform_items(parent).childCounts[parent & DB_CHUNK_MASK]++;
+        g_gfxResourceDb->transformHierarchy.dirty = true;
+    }
 }
 
-VkDescriptorSet *gfx_db_get_descriptor_set(uint32_t index) {
-    ASSERT_MSG(index < MAX_DB_VK_DESCRIPTOR_SETS, "Err: invalid db index %u, max index [%u]", index, MAX_DB_VK_DESCRIPTOR_SETS);
-    return &s_dbDescriptorSet[index];
+Transform gfx_db_get_transform(DbHandle handle) {
+    const DbChunk<Transform> &chunk = pool_validate(g_gfxResourceDb->transforms, handle);
+    return chunk.items.load(handle.index & DB_CHUNK_MASK);
 }
 
-uint32_t gfx_db_add_lit_material(const LitMaterial &litMaterial) {
-    ASSERT_MSG(s_dbLitMaterialsCount < MAX_DB_LIT_MATERIALS, "Err: exceeded pre-allocated amount of lit materials sets %u, max amount [%u]",
-               s_dbLitMaterialsCount, MAX_DB_LIT_MATERIALS);
-    uint32_t currentLitMaterialsIndex = s_dbLitMaterialsCount;
-    s_dbLitMaterials[currentLitMaterialsIndex] = litMaterial;
-    s_dbLitMaterialsCount++;
-    return currentLitMaterialsIndex;
+void gfx_db_set_transform(DbHandle handle, const Transform &transform) {
+    DbChunk<Transform> &chunk = pool_validate(g_gfxResourceDb->transforms, handle);
+    chunk.items.store(handle.index & DB_CHUNK_MASK, transform);
 }
 
-LitMaterial *gfx_db_get_lit_material(uint32_t index) {
-    ASSERT_MSG(index < MAX_DB_LIT_MATERIALS, "Err: invalid db index %u, max index [%u]", index, MAX_DB_LIT_MATERIALS);
-    return &s_dbLitMaterials[index];
+const mat4 *gfx_db_get_world_matrix(DbHandle handle) {
+    const DbChunk<Transform> &chunk = pool_validate(g_gfxResourceDb->transforms, handle);
+    return &chunk.items.worldMatrices[handle.index & DB_CHUNK_MASK];
 }
 
-uint32_t gfx_db_add_font_material(const FontMaterial &fontMaterial) {
-    ASSERT_MSG(s_dbFontMaterialsCount < MAX_DB_FONT_MATERIALS, "Err: exceeded pre-allocated amount of font materials sets %u, max amount [%u]",
-               s_dbFontMaterialsCount, MAX_DB_FONT_MATERIALS);
-    uint32_t currentFontMaterialsIndex = s_dbFontMaterialsCount;
-    s_dbFontMaterials[currentFontMaterialsIndex] = fontMaterial;
-    s_dbFontMaterialsCount++;
-    return currentFontMaterialsIndex;
+uint32_t gfx_db_commit_concurrent_adds() {
+    BEET_PROFILE_SCOPE("gfx_db_commit_concurrent_adds");
+    return pool_commit(g_gfxResourceDb->textures) + pool_commit(g_gfxResourceDb->meshes);
 }
 
-FontMaterial *gfx_db_get_font_material(uint32_t index) {
-    ASSERT_MSG(index < MAX_DB_FONT_MATERIALS, "Err: invalid db index %u, max index [%u]", index, MAX_DB_FONT_MATERIALS);
-    return &s_dbFontMaterials[index];
+uint32_t gfx_db_update_world_matrices(GfxParallelFor parallelFor) {
+    BEET_PROFILE_SCOPE("gfx_db_update_world_matrices");
+    const DbPool<Transform> &pool = g_gfxResourceDb->transforms;
+    TransformHierarchy &hierarchy = g_gfxResourceDb->transformHierarchy;
+    hierarchy.version = hierarchy.version + 1 != 0 ? hierarchy.version + 1 : 1;
+
+    WorldMatrixRebuild rebuild{&pool, hierarchy.version, {0}};
+    const uint32_t chunkCount = chunks_for_slots(pool.slotCount);
+    if (parallelFor != nullptr) {
+        parallelFor(chunkCount, 1, rebuild_world_matrix_chunks, &rebuild);
+    } else {
+        rebuild_world_matrix_chunks(&rebuild, 0, chunkCount);
+    }
+    uint32_t updated = rebuild.updated.load(std::memory_order_relaxed);
+
+    if (hierarchy.dirty) {
+        transform_hierarchy_rebuild(hierarchy, pool);
+    }
+    // parents come first, so a changed parent has already bumped its version when its children are reached.
+    for (uint32_t i = 0; i < hierarchy.count; ++i) {
+        const uint32_t slot = (uint32_t) hierarchy.order[i];
+        DbItems<Transform> &items = transform_items(slot);
+        const uint32_t local = slot & DB_CHUNK_MASK;
+        const uint32_t parent = items.parents[local];
+        const DbItems<Transform> &parentItems = transform_items(parent);
+        const uint32_t parentLocal = parent & DB_CHUNK_MASK;
+        if (items.worldVersions[local] != hierarchy.version && parentItems.worldVersions[parentLocal] != hierarchy.version) {
+            continue;
+        }
+        items.worldMatrices[local] = parentItems.worldMatrices[parentLocal] * items.localMatrices[local];
+        items.worldVersions[local] = hierarchy.version;
+        updated++;
+    }
+    return updated;
 }
 
-uint32_t gfx_db_add_transform(const Transform &transform) {
-    ASSERT_MSG(s_dbTransformsCount < MAX_DB_TRANSFORMS, "Err: exceeded pre-allocated amount of transforms %u, max amount [%u]",
-               s_dbTransformsCount, MAX_DB_TRANSFORMS);
-    uint32_t currentTransformIndex = s_dbTransformsCount;
-    s_dbTransforms[currentTransformIndex] = transform;
-    s_dbTransformsCount++;
-    return currentTransformIndex;
+void gfx_db_remove_transform(DbHandle handle) {
+    const DbPool<Transform> &pool = g_gfxResourceDb->transforms;
+    DbItems<Transform> &items = pool_validate(g_gfxResourceDb->transforms, handle).items;
+    const uint32_t local = handle.index & DB_CHUNK_MASK;
+    if (items.childCounts[local] > 0) {
+        // children become roots, keeping their local transform.
+        for (uint32_t slot = 0; slot < pool.slotCount && items.childCounts[local] > 0; ++slot) {
+            if (transform_items(slot).parents[slot & DB_CHUNK_MASK] == handle.index) {
+                transform_detach(slot);
+            }
+        }
+    }
+    transform_detach(handle.index);
+    pool_remove(g_gfxResourceDb->transforms, handle);
 }
 
-Transform *gfx_db_get_transform(uint32_t index) {
-    ASSERT_MSG(index < MAX_DB_TRANSFORMS, "Err: invalid db index %u, max index [%u]", index, MAX_DB_TRANSFORMS);
-    return &s_dbTransforms[index];
+void gfx_db_set_transform_parent(DbHandle handle, DbHandle parentHandle) {
+    DbPool<Transform> &pool = g_gfxResourceDb->transforms;
+    pool_validate(pool, handle);
+    transform_detach(handle.index);
+    if (parentHandle.generation == DB_INVALID_GENERATION) {
+        return;
+    }
+    pool_validate(pool, parentHandle);
+    for (uint32_t slot = parentHandle.index; slot != DB_SLOT_NONE; slot = transform_items(slot).parents[slot & DB_CHUNK_MASK]) {
+        ASSERT_MSG(slot != handle.index, "Err: transform [%u] can't be parented to its own descendant [%u]", handle.index, parentHandle.index);
+    }
+
+    DbItems<Transform> &items = transform_items(handle.index);
+    const uint32_t local = handle.index & DB_CHUNK_MASK;
+    items.parents[local] = parentHandle.index;
+    items.mark_dirty(local);
+    transform_items(parentHandle.index).childCounts[parentHandle.index & DB_CHUNK_MASK]++;
+    g_gfxResourceDb->transformHierarchy.dirty = true;
 }
 
-uint32_t gfx_db_add_ui_transform(const UiTransform &uiTransform) {
-    ASSERT_MSG(s_dbUiTransformsCount < MAX_DB_UI_TRANSFORMS, "Err: exceeded pre-allocated amount of ui transforms %u, max amount [%u]",
-               s_dbUiTransformsCount, MAX_DB_UI_TRANSFORMS);
-    uint32_t currentUiTransformIndex = s_dbUiTransformsCount;
-    s_dbUiTransforms[currentUiTransformIndex] = uiTransform;
-    s_dbUiTransformsCount++;
-    return currentUiTransformIndex;
+DbHandle gfx_db_get_transform_parent(DbHandle handle) {
+    const DbChunk<Transform> &chunk = pool_validate(g_gfxResourceDb->transforms, handle);
+    const uint32_t parent = chunk.items.parents[handle.index & DB_CHUNK_MASK];
+    if (parent == DB_SLOT_NONE) {
+        return DbHandle{};
+    }
+    return DbHandle{parent, g_gfxResourceDb->transforms.chunks[parent >> DB_CHUNK_SHIFT].generations[parent & DB_CHUNK_MASK]};
 }
 
-UiTransform *gfx_db_get_ui_transform(uint32_t index) {
-    ASSERT_MSG(index < MAX_DB_UI_TRANSFORMS, "Err: invalid db index %u, max index [%u]", index, MAX_DB_UI_TRANSFORMS);
-    return &s_dbUiTransforms[index];
-}
\ No newline at end of file
+DbHandle gfx_db_add_ui_transform(const UiTransform &uiTransform) {
+    return pool_add(g_gfxResourceDb->uiTransforms, uiTransform);
+}
+
+void gfx_db_add_ui_transforms(const UiTransform *uiTransforms, uint32_t count, DbHandle *outHandles) {
+    pool_add_range(g_gfxResourceDb->uiTransforms, uiTransforms, count, outHandles);
+}
+
+UiTransform *gfx_db_get_ui_transform(DbHandle handle) {
+    return pool_get(g_gfxResourceDb->uiTransforms, handle);
+}
+
+void gfx_db_remove_ui_transform(DbHandle handle) {
+    pool_remove(g_gfxResourceDb->uiTransforms, handle);
+}
@@ -0,0 +1,82 @@
+#include <gfx/gfx_stats.h>
+#include <gfx/gfx_types.h>
+
+#include <shared/log.h>
+
+#include <vk_mem_alloc.h>
+
+extern struct GfxDevice *g_gfxDevice;
+
+//===internal structs========
+struct GfxFrameStats {
+    GfxStats current;
+    GfxStats last;
+    uint64_t frameIndex;
+    uint32_t logInterval;
+};
+
+GfxFrameStats *g_gfxFrameStats;
+
+//===api=====================
+const GfxStats *gfx_stats() {
+    return &g_gfxFrameStats->last;
+}
+
+GfxStats *gfx_stats_frame() {
+    return &g_gfxFrameStats->current;
+}
+
+void gfx_stats_end_frame() {
+    GfxFrameStats &frameStats = *g_gfxFrameStats;
+    frameStats.last = frameStats.current;
+    frameStats.current = {};
+    if (frameStats.logInterval > 0 && frameStats.frameIndex % frameStats.logInterval == 0) {
+        log_info(MSG_GFX, "frame %llu\n", (unsigned long long) frameStats.frameIndex);
+        gfx_stats_log();
+    }
+    frameStats.frameIndex++;
+}
+
+void gfx_stats_log() {
+    const GfxStats &stats = g_gfxFrameStats->last;
+    log_info(MSG_GFX, "draws: %u triangles: %llu indices: %llu\n",
+             stats.drawCalls, (unsigned long long) stats.triangles, (unsigned long long) stats.indices);
+    log_info(MSG_GFX, "binds pipeline: %u descriptor set: %u vertex buffer: %u index buffer: %u push constants: %u\n",
+             stats.pipelineBinds, stats.descriptorSetBinds, stats.vertexBufferBinds, stats.indexBufferBinds, stats.pushConstantUpdates);
+    log_info(MSG_GFX, "world matrix updates: %u\n", stats.worldMatrixUpdates);
+    log_info(MSG_GFX, "uploads: %u bytes: %llu\n", stats.uploads, (unsigned long long) stats.uploadBytes);
+}
+
+void gfx_stats_set_log_interval(uint32_t frames) {
+    g_gfxFrameStats->logInterval = frames;
+}
+
+void gfx_stats_log_memory_budgets() {
+    const VkPhysicalDeviceMemoryProperties *memoryProperties = nullptr;
+    vmaGetMemoryProperties(g_gfxDevice->vmaAllocator, &memoryProperties);
+
+    VmaBudget budgets[VK_MAX_MEMORY_HEAPS] = {};
+    vmaGetHeapBudgets(g_gfxDevice->vmaAllocator, budgets);
+
+    for (uint32_t i = 0; i < memoryProperties->memoryHeapCount; ++i) {
+        const VmaBudget &budget = budgets[i];
+        const bool deviceLocal = (memoryProperties->memoryHeaps[i].flags & VK_MEMORY_HEAP_DEVICE_LOCAL_BIT) != 0;
+        log_info(MSG_GFX, "heap %u (%s) allocations: %u allocated: %llu bytes blocks: %llu bytes usage: %llu / %llu bytes\n",
+                 i, deviceLocal ? "device" : "host",
+                 budget.statistics.allocationCount,
+                 (unsigned long long) budget.statistics.allocationBytes,
+                 (unsigned long long) budget.statistics.blockBytes,
+                 (unsigned long long) budget.usage,
+                 (unsigned long long) budget.budget);
+    }
+}
+
+//===init & shutdown=========
+void gfx_create_stats() {
+    g_gfxFrameStats = new GfxFrameStats{};
+}
+
+void gfx_cleanup_stats() {
+    delete g_gfxFrameStats;
+    g_gfxFrameStats = nullptr;
+}
@@ -1,12 +1,33 @@
 #include <gfx/gfx_texture.h>
 #include <gfx/gfx_command.h>
 #include <gfx/gfx_samplers.h>
+#include <gfx/gfx_stats.h>
+#include <gfx/gfx_upload.h>
 
 #include <shared/texture_formats.h>
 #include <shared/dds_loader.h>
+#include <shared/mem_tracker.h>
+#include <shared/profiler.h>
 
 extern struct GfxDevice *g_gfxDevice;
 
+//===defines=================
+// staging offsets are aligned to the largest block size of any supported format.
+#define TEXTURE_STAGING_ALIGNMENT 16u
+
+//===internal structs========
+struct TextureBatch {
+    const char **paths;
+    uint32_t count;
+    RawImage *images;
+    VkDeviceSize *stagingOffsets;
+    VkImageMemoryBarrier *barriers;
+    GfxTexture *outTextures;
+
+    unsigned char *staging;
+    GfxStagingAlloc stagingAlloc;
+};
+
 VkFormat beet_image_format_to_vk(TextureFormat textureFormat) {
     switch (textureFormat) {
         case TextureFormat::RGBA8:
@@ -33,71 +54,33 @@ VkFormat beet_image_format_to_vk(TextureFormat textureFormat) {
     return VK_FORMAT_UNDEFINED;
 }
 
-void gfx_create_texture_immediate(const char* path, GfxTexture &outTexture) {
-    ASSERT_MSG(g_gfxDevice->vmaAllocator, "Err: vma allocator hasn't been created yet");
-    // TODO: select sampler type during pipeline and pass it through to here
-    outTexture.imageSamplerType = TextureSamplerType::Linear;
-
-    RawImage myImage{};
-    load_dds_image(path, &myImage);
-    auto rawImageData = (unsigned char *) myImage.data;
-
-    const uint32_t sizeX = myImage.width;
-    const uint32_t sizeY = myImage.height;
-    const uint32 mipMapCount = myImage.mipMapCount;
-    const VkDeviceSize imageSize = myImage.dataSize;
-
-    VkBufferCreateInfo stagingBufInfo = {VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO};
-    stagingBufInfo.size = imageSize;
-    stagingBufInfo.usage = VK_BUFFER_USAGE_TRANSFER_SRC_BIT;
-
-    VmaAllocationCreateInfo stagingBufAllocCreateInfo = {};
-    stagingBufAllocCreateInfo.usage = VMA_MEMORY_USAGE_AUTO;
-    stagingBufAllocCreateInfo.flags = VMA_ALLOCATION_CREATE_HOST_ACCESS_SEQUENTIAL_WRITE_BIT | VMA_ALLOCATION_CREATE_MAPPED_BIT;
-
-    VkBuffer stagingBuf = VK_NULL_HANDLE;
-    VmaAllocation stagingBufAlloc = VK_NULL_HANDLE;
-    VmaAllocationInfo stagingBufAllocInfo = {};
+//===internal functions======
+static void batch_query_range(void *args, uint32_t begin, uint32_t end) {
+    TextureBatch &batch = *(TextureBatch *) args;
+    for (uint32_t i = begin; i < end; ++i) {
+        query_dds_image(batch.paths[i], &batch.images[i]);
+    }
+}
 
-    VkResult createBufferRes = vmaCreateBuffer(
-            g_gfxDevice->vmaAllocator,
-            &stagingBufInfo,
-            &stagingBufAllocCreateInfo,
-            &stagingBuf,
-            &stagingBufAlloc,
-            &stagingBufAllocInfo
-    );
-    ASSERT_MSG(createBufferRes == VK_SUCCESS, "Err: Failed to create staging buffers");
-    uint8_t *data;
-    vmaMapMemory(g_gfxDevice->vmaAllocator, stagingBufAlloc, (void **) &data);
-    memcpy(data, rawImageData, imageSize);
-    vmaUnmapMemory(g_gfxDevice->vmaAllocator, stagingBufAlloc);
-
-    VkBufferImageCopy *bufferCopyRegions = (VkBufferImageCopy *) malloc(mipMapCount * sizeof(VkBufferImageCopy));
-    uint32_t offset = 0;
-    for (uint32_t i = 0; i < mipMapCount; i++) {
-        // setup a buffer image copy structure for the current mip level
-        VkBufferImageCopy bufferCopyRegion = {};
-        bufferCopyRegion.imageSubresource.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
-        bufferCopyRegion.imageSubresource.mipLevel = i;
-        bufferCopyRegion.imageSubresource.baseArrayLayer = 0;
-        bufferCopyRegion.imageSubresource.layerCount = 1;
-        bufferCopyRegion.imageExtent.width = myImage.width >> i;
-        bufferCopyRegion.imageExtent.height = myImage.height >> i;
-        bufferCopyRegion.imageExtent.depth = 1;
-        bufferCopyRegion.bufferOffset = offset;
-        bufferCopyRegions[i] = bufferCopyRegion;
-        offset += myImage.mipDataSizes[i];
+static void batch_read_range(void *args, uint32_t begin, uint32_t end) {
+    TextureBatch &batch = *(TextureBatch *) args;
+    for (uint32_t i = begin; i < end; ++i) {
+        read_dds_payload(batch.paths[i], &batch.images[i], batch.staging + batch.stagingOffsets[i], batch.images[i].dataSize);
     }
+}
+
+static void create_texture_image(const RawImage &image, GfxTexture &outTexture) {
+    // TODO: select sampler type during pipeline and pass it through to here
+    outTexture.imageSamplerType = TextureSamplerType::Linear;
 
     VkImageCreateInfo imageInfo = {VK_STRUCTURE_TYPE_IMAGE_CREATE_INFO};
     imageInfo.imageType = VK_IMAGE_TYPE_2D;
-    imageInfo.extent.width = sizeX;
-    imageInfo.extent.height = sizeY;
+    imageInfo.extent.width = image.width;
+    imageInfo.extent.height = image.height;
     imageInfo.extent.depth = 1;
-    imageInfo.mipLevels = mipMapCount;
+    imageInfo.mipLevels = image.mipMapCount;
     imageInfo.arrayLayers = 1;
-    imageInfo.format = beet_image_format_to_vk(myImage.textureFormat);
+    imageInfo.format = beet_image_format_to_vk(image.textureFormat);
     imageInfo.tiling = VK_IMAGE_TILING_OPTIMAL;
     imageInfo.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
     imageInfo.usage = VK_IMAGE_USAGE_TRANSFER_DST_BIT | VK_IMAGE_USAGE_SAMPLED_BIT;
@@ -117,76 +100,200 @@ void gfx_create_texture_immediate(const char* path, GfxTexture &outTexture) {
             nullptr
     );
     ASSERT_MSG(imageRes == VK_SUCCESS, "Err: failed to allocate image");
+}
 
-    gfx_command_begin_immediate_recording();
+static void create_texture_view(const RawImage &image, GfxTexture &outTexture) {
+    VkImageViewCreateInfo view{VK_STRUCTURE_TYPE_IMAGE_VIEW_CREATE_INFO};
+    view.viewType = VK_IMAGE_VIEW_TYPE_2D;
+    view.format = beet_image_format_to_vk(image.textureFormat);
+    view.subresourceRange.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+    view.subresourceRange.baseMipLevel = 0;
+    view.subresourceRange.baseArrayLayer = 0;
+    view.subresourceRange.layerCount = 1;
+    view.subresourceRange.levelCount = image.mipMapCount;
+    view.image = outTexture.imageTexture;
+    vkCreateImageView(g_gfxDevice->vkDevice, &view, nullptr, &outTexture.imageView);
+}
 
+static VkImageMemoryBarrier texture_layout_barrier(const RawImage &image, const GfxTexture &texture) {
     VkImageSubresourceRange subresourceRange = {};
     subresourceRange.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
     subresourceRange.baseMipLevel = 0;
-    subresourceRange.levelCount = mipMapCount;
+    subresourceRange.levelCount = image.mipMapCount;
     subresourceRange.layerCount = 1;
 
     VkImageMemoryBarrier imageMemoryBarrier{};
     imageMemoryBarrier.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
     imageMemoryBarrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
     imageMemoryBarrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
-    imageMemoryBarrier.image = outTexture.imageTexture;
+    imageMemoryBarrier.image = texture.imageTexture;
     imageMemoryBarrier.subresourceRange = subresourceRange;
     imageMemoryBarrier.srcAccessMask = 0;
     imageMemoryBarrier.dstAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
     imageMemoryBarrier.oldLayout = VK_IMAGE_LAYOUT_UNDEFINED;
     imageMemoryBarrier.newLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
+    return imageMemoryBarrier;
+}
+
+static void record_texture_copy(VkCommandBuffer cmd, VkBuffer stagingBuf, const VkDeviceSize stagingOffset, const RawImage &image, const GfxTexture &texture) {
+    VkBufferImageCopy bufferCopyRegions[BEET_MAX_MIP_COUNT] = {};
+    VkDeviceSize offset = stagingOffset;
+    for (uint32_t i = 0; i < image.mipMapCount; i++) {
+        // setup a buffer image copy structure for the current mip level
+        VkBufferImageCopy &bufferCopyRegion = bufferCopyRegions[i];
+        bufferCopyRegion.imageSubresource.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+        bufferCopyRegion.imageSubresource.mipLevel = i;
+        bufferCopyRegion.imageSubresource.baseArrayLayer = 0;
+        bufferCopyRegion.imageSubresource.layerCount = 1;
+        bufferCopyRegion.imageExtent.width = image.width >> i;
+        bufferCopyRegion.imageExtent.height = image.height >> i;
+        bufferCopyRegion.imageExtent.depth = 1;
+        bufferCopyRegion.bufferOffset = offset;
+        offset += image.mipDataSizes[i];
+    }
 
+    vkCmdCopyBufferToImage(
+            cmd,
+            stagingBuf,
+            texture.imageTexture,
+            VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+            image.mipMapCount,
+            &bufferCopyRegions[0]);
+}
+
+// reads every file into one staging slice & creates the images, nothing is recorded yet.
+static void batch_prepare(TextureBatch &batch, GfxParallelFor parallelFor) {
+    const uint32_t count = batch.count;
+    batch.images = (RawImage *) mem_malloc(MSG_GFX, count * sizeof(RawImage));
+    batch.stagingOffsets = (VkDeviceSize *) mem_malloc(MSG_GFX, count * sizeof(VkDeviceSize));
+    batch.barriers = (VkImageMemoryBarrier *) mem_malloc(MSG_GFX, count * sizeof(VkImageMemoryBarrier));
+
+    // headers first so every texture gets a slice of one staging buffer.
+    if (parallelFor != nullptr) {
+        parallelFor(count, 1, batch_query_range, &batch);
+    } else {
+        batch_query_range(&batch, 0, count);
+    }
+
+    VkDeviceSize stagingSize = 0;
+    for (uint32_t i = 0; i < count; ++i) {
+        stagingSize = (stagingSize + TEXTURE_STAGING_ALIGNMENT - 1) & ~(VkDeviceSize) (TEXTURE_STAGING_ALIGNMENT - 1);
+        batch.stagingOffsets[i] = stagingSize;
+        stagingSize += batch.images[i].dataSize;
+    }
+
+    // the payloads are read straight into the mapped staging ring, each worker writes its own slices.
+    batch.stagingAlloc = gfx_staging_alloc(stagingSize, TEXTURE_STAGING_ALIGNMENT);
+    batch.staging = (unsigned char *) batch.stagingAlloc.mapped;
+    if (parallelFor != nullptr) {
+        parallelFor(count, 1, batch_read_range, &batch);
+    } else {
+        batch_read_range(&batch, 0, count);
+    }
+    gfx_staging_flush(batch.stagingAlloc);
+    gfx_stats_frame()->uploads += count;
+    gfx_stats_frame()->uploadBytes += stagingSize;
+
+    for (uint32_t i = 0; i < count; ++i) {
+        create_texture_image(batch.images[i], batch.outTextures[i]);
+        batch.barriers[i] = texture_layout_barrier(batch.images[i], batch.outTextures[i]);
+    }
+}
+
+// moves every image to TRANSFER_DST_OPTIMAL & copies its mips out of the staging buffer.
+static void batch_record_copies(TextureBatch &batch, VkCommandBuffer cmd, const VkPipelineStageFlags srcStage) {
     vkCmdPipelineBarrier(
-            g_gfxDevice->vkImmediateCommandBuffer,
-            VK_PIPELINE_STAGE_HOST_BIT,
+            cmd,
+            srcStage,
             VK_PIPELINE_STAGE_TRANSFER_BIT,
             0,
             0, nullptr,
             0, nullptr,
-            1, &imageMemoryBarrier);
+            batch.count, batch.barriers);
 
-    vkCmdCopyBufferToImage(
-            g_gfxDevice->vkImmediateCommandBuffer,
-            stagingBuf,
-            outTexture.imageTexture,
-            VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
-            static_cast<uint32_t>(mipMapCount),
-            &bufferCopyRegions[0]);
+    for (uint32_t i = 0; i < batch.count; ++i) {
+        record_texture_copy(cmd, batch.stagingAlloc.buffer, batch.stagingAlloc.offset + batch.stagingOffsets[i], batch.images[i], batch.outTextures[i]);
+    }
 
-    imageMemoryBarrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
-    imageMemoryBarrier.dstAccessMask = VK_ACCESS_SHADER_READ_BIT;
-    imageMemoryBarrier.oldLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
-    imageMemoryBarrier.newLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+    for (uint32_t i = 0; i < batch.count; ++i) {
+        batch.barriers[i].srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+        batch.barriers[i].dstAccessMask = VK_ACCESS_SHADER_READ_BIT;
+        batch.barriers[i].oldLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
+        batch.barriers[i].newLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+    }
+}
 
+static void batch_finish(TextureBatch &batch) {
+    for (uint32_t i = 0; i < batch.count; ++i) {
+        batch.outTextures[i].imageLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+        create_texture_view(batch.images[i], batch.outTextures[i]);
+    }
+    mem_free(batch.barriers);
+    mem_free(batch.stagingOffsets);
+    mem_free(batch.images);
+}
+
+//===api=====================
+void gfx_create_texture_immediate(const char *path, GfxTexture &outTexture) {
+    gfx_create_textures_batch(&path, 1, &outTexture, nullptr);
+}
+
+void gfx_create_textures_batch(const char **paths, uint32_t count, GfxTexture *outTextures, GfxParallelFor parallelFor) {
+    ASSERT_MSG(g_gfxDevice->vmaAllocator, "Err: vma allocator hasn't been created yet");
+    if (count == 0) {
+        return;
+    }
+    BEET_PROFILE_SCOPE("gfx_create_textures_batch");
+
+    TextureBatch batch{};
+    batch.paths = paths;
+    batch.count = count;
+    batch.outTextures = outTextures;
+    batch_prepare(batch, parallelFor);
+
+    // every copy goes into one command buffer, the whole batch costs a single submit & wait.
+    gfx_command_begin_immediate_recording();
+    VkCommandBuffer cmd = g_gfxDevice->vkImmediateCommandBuffer;
+    batch_record_copies(batch, cmd, VK_PIPELINE_STAGE_HOST_BIT);
     vkCmdPipelineBarrier(
-            g_gfxDevice->vkImmediateCommandBuffer,
+            cmd,
             VK_PIPELINE_STAGE_TRANSFER_BIT,
             VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT,
             0,
             0, nullptr,
             0, nullptr,
-            1, &imageMemoryBarrier);
+            count, batch.barriers);
+    gfx_command_end_immediate_recording();
 
-    outTexture.imageLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+    gfx_staging_release(batch.stagingAlloc, 0);
+    batch_finish(batch);
+}
 
-    gfx_command_end_immediate_recording();
+uint64_t gfx_create_textures_async(const char **paths, uint32_t count, GfxTexture *outTextures, GfxParallelFor parallelFor) {
+    if (!gfx_upload_async_supported()) {
+        gfx_create_textures_batch(paths, count, outTextures, parallelFor);
+        return 0;
+    }
+    ASSERT_MSG(g_gfxDevice->vmaAllocator, "Err: vma allocator hasn't been created yet");
+    if (count == 0) {
+        return 0;
+    }
+    BEET_PROFILE_SCOPE("gfx_create_textures_async");
 
-    VkImageViewCreateInfo view{VK_STRUCTURE_TYPE_IMAGE_VIEW_CREATE_INFO};
-    view.viewType = VK_IMAGE_VIEW_TYPE_2D;
-    view.format = beet_image_format_to_vk(myImage.textureFormat);;
-    view.subresourceRange.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
-    view.subresourceRange.baseMipLevel = 0;
-    view.subresourceRange.baseArrayLayer = 0;
-    view.subresourceRange.layerCount = 1;
-    view.subresourceRange.levelCount = mipMapCount;
-    view.image = outTexture.imageTexture;
-    vkCreateImageView(g_gfxDevice->vkDevice, &view, nullptr, &outTexture.imageView);
+    TextureBatch batch{};
+    batch.paths = paths;
+    batch.count = count;
+    batch.outTextures = outTextures;
+    batch_prepare(batch, parallelFor);
+
+    // the host writes are visible to the transfer queue once it's submitted, nothing to wait on before the copies.
+    VkCommandBuffer cmd = gfx_upload_begin_recording();
+    batch_record_copies(batch, cmd, VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT);
+    // the staging slice is now owned by the upload queue & recycled once the transfer has finished.
+    const uint64_t ticket = gfx_upload_submit(cmd, batch.stagingAlloc, batch.barriers, count, nullptr, 0);
 
-    vmaDestroyBuffer(g_gfxDevice->vmaAllocator, stagingBuf, stagingBufAlloc);
-    free(myImage.data);
-    free(bufferCopyRegions);
-    myImage.data = nullptr;
+    batch_finish(batch);
+    return ticket;
 }
 
 void gfx_cleanup_texture(GfxTexture &gfxTexture) {
@@ -196,8 +303,5 @@ void gfx_cleanup_texture(GfxTexture &gfxTexture) {
     vmaDestroyImage(g_gfxDevice->vmaAllocator, gfxTexture.imageTexture, gfxTexture.imageAllocation);
     gfxTexture.imageTexture = VK_NULL_HANDLE;
 
-    //TODO:GFX We don't re-add this as a free slot in the texture pool i.e.
-    //we could address this pretty simply in a few ways.
-    //create free-list for each pool and next time we try and create a new texture to check if any free list spaces are free
-    //we move the last image loaded into the newly free position and fix up and dependency, this will break any cached references.
+    // the db slot is not owned here, gfx_db_remove_texture returns it to the texture pool's free list.
 }
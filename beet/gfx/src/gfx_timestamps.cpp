@@ -0,0 +1,126 @@
+#include <gfx/gfx_timestamps.h>
+#include <gfx/gfx_types.h>
+
+#include <shared/assert.h>
+#include <shared/log.h>
+
+extern struct GfxDevice *g_gfxDevice;
+
+//===internal structs========
+// a begin & end timestamp per pass.
+static const uint32_t BEET_VK_TIMESTAMP_QUERY_COUNT = GfxTimestampPass::PASS_COUNT * 2;
+
+struct GfxTimestamps {
+    bool supported{false};
+    double nanosecondsPerTick{};
+    uint64_t validMask{};
+    double passMs[GfxTimestampPass::PASS_COUNT]{};
+};
+
+GfxTimestamps *g_gfxTimestamps;
+
+//===api=====================
+void gfx_timestamps_reset(VkCommandBuffer &cmdBuffer) {
+    if (!g_gfxTimestamps->supported) {
+        return;
+    }
+    const uint32_t frameIndex = g_gfxDevice->nextCommandBufferIndex;
+    vkCmdResetQueryPool(cmdBuffer, g_gfxDevice->vkTimestampQueryPools[frameIndex], 0, BEET_VK_TIMESTAMP_QUERY_COUNT);
+    g_gfxDevice->timestampQueryPoolWritten[frameIndex] = true;
+}
+
+void gfx_timestamps_begin_pass(VkCommandBuffer &cmdBuffer, GfxTimestampPass pass) {
+    if (!g_gfxTimestamps->supported) {
+        return;
+    }
+    const uint32_t frameIndex = g_gfxDevice->nextCommandBufferIndex;
+    vkCmdWriteTimestamp(cmdBuffer, VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT, g_gfxDevice->vkTimestampQueryPools[frameIndex], pass * 2);
+}
+
+void gfx_timestamps_end_pass(VkCommandBuffer &cmdBuffer, GfxTimestampPass pass) {
+    if (!g_gfxTimestamps->supported) {
+        return;
+    }
+    const uint32_t frameIndex = g_gfxDevice->nextCommandBufferIndex;
+    vkCmdWriteTimestamp(cmdBuffer, VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT, g_gfxDevice->vkTimestampQueryPools[frameIndex], pass * 2 + 1);
+}
+
+void gfx_timestamps_collect() {
+    const uint32_t frameIndex = g_gfxDevice->nextCommandBufferIndex;
+    if (!g_gfxTimestamps->supported || !g_gfxDevice->timestampQueryPoolWritten[frameIndex]) {
+        return;
+    }
+
+    // no VK_QUERY_RESULT_WAIT_BIT, the fence has already signaled so anything not ready is skipped rather than stalled on.
+    uint64_t results[BEET_VK_TIMESTAMP_QUERY_COUNT]{};
+    const VkResult result = vkGetQueryPoolResults(
+            g_gfxDevice->vkDevice,
+            g_gfxDevice->vkTimestampQueryPools[frameIndex],
+            0, BEET_VK_TIMESTAMP_QUERY_COUNT,
+            sizeof(results), results, sizeof(uint64_t),
+            VK_QUERY_RESULT_64_BIT
+    );
+    if (result != VK_SUCCESS) {
+        return;
+    }
+
+    for (uint32_t pass = 0; pass < GfxTimestampPass::PASS_COUNT; ++pass) {
+        const uint64_t begin = results[pass * 2] & g_gfxTimestamps->validMask;
+        const uint64_t end = results[pass * 2 + 1] & g_gfxTimestamps->validMask;
+        const uint64_t ticks = end >= begin ? end - begin : 0;
+        g_gfxTimestamps->passMs[pass] = (double) ticks * g_gfxTimestamps->nanosecondsPerTick / 1000000.0;
+    }
+}
+
+double gfx_timestamps_pass_ms(GfxTimestampPass pass) {
+    return g_gfxTimestamps->passMs[pass];
+}
+
+bool gfx_timestamps_supported() {
+    return g_gfxTimestamps->supported;
+}
+
+//===init & shutdown=========
+void gfx_create_timestamps() {
+    g_gfxTimestamps = new GfxTimestamps;
+
+    VkPhysicalDeviceProperties deviceProperties{};
+    vkGetPhysicalDeviceProperties(g_gfxDevice->vkPhysicalDevice, &deviceProperties);
+
+    uint32_t queueFamilyCount = 0;
+    vkGetPhysicalDeviceQueueFamilyProperties(g_gfxDevice->vkPhysicalDevice, &queueFamilyCount, nullptr);
+    VkQueueFamilyProperties *queueFamilies = new VkQueueFamilyProperties[queueFamilyCount];
+    vkGetPhysicalDeviceQueueFamilyProperties(g_gfxDevice->vkPhysicalDevice, &queueFamilyCount, queueFamilies);
+    const uint32_t validBits = queueFamilies[g_gfxDevice->graphicsQueueIndex].timestampValidBits;
+    delete[] queueFamilies;
+
+    g_gfxTimestamps->supported = validBits > 0 && deviceProperties.limits.timestampPeriod > 0.0f;
+    if (!g_gfxTimestamps->supported) {
+        log_warning(MSG_GFX, "gpu timestamps are not supported on the graphics queue\n");
+        return;
+    }
+    g_gfxTimestamps->nanosecondsPerTick = deviceProperties.limits.timestampPeriod;
+    g_gfxTimestamps->validMask = validBits >= 64 ? UINT64_MAX : (uint64_t(1) << validBits) - 1;
+
+    VkQueryPoolCreateInfo queryPoolInfo = {VK_STRUCTURE_TYPE_QUERY_POOL_CREATE_INFO};
+    queryPoolInfo.queryType = VK_QUERY_TYPE_TIMESTAMP;
+    queryPoolInfo.queryCount = BEET_VK_TIMESTAMP_QUERY_COUNT;
+    for (uint32_t i = 0; i < BEET_VK_COMMAND_BUFFER_COUNT; ++i) {
+        VkResult queryPoolResult = vkCreateQueryPool(g_gfxDevice->vkDevice, &queryPoolInfo, nullptr, &g_gfxDevice->vkTimestampQueryPools[i]);
+        ASSERT_MSG(queryPoolResult == VK_SUCCESS, "Err: failed to create timestamp query pool [%u]", i);
+        g_gfxDevice->timestampQueryPoolWritten[i] = false;
+    }
+}
+
+void gfx_cleanup_timestamps() {
+    for (uint32_t i = 0; i < BEET_VK_COMMAND_BUFFER_COUNT; ++i) {
+        if (g_gfxDevice->vkTimestampQueryPools[i] != VK_NULL_HANDLE) {
+            vkDestroyQueryPool(g_gfxDevice->vkDevice, g_gfxDevice->vkTimestampQueryPools[i], nullptr);
+            g_gfxDevice->vkTimestampQueryPools[i] = VK_NULL_HANDLE;
+        }
+        g_gfxDevice->timestampQueryPoolWritten[i] = false;
+    }
+
+    delete g_gfxTimestamps;
+    g_gfxTimestamps = nullptr;
+}
@@ -0,0 +1,421 @@
+#include <gfx/gfx_upload.h>
+
+#include <shared/assert.h>
+#include <shared/log.h>
+#include <shared/mem_tracker.h>
+#include <shared/profiler.h>
+
+#include <deque>
+#include <vector>
+
+extern struct GfxDevice *g_gfxDevice;
+
+//===defines=================
+// timeline value of a ring region that hasn't been released yet.
+#define GFX_STAGING_PENDING UINT64_MAX
+
+//===internal structs========
+template<typename T>
+using UploadVector = std::vector<T, MemAllocator<T, MSG_GFX>>;
+
+struct GfxUploadSubmission {
+    uint64_t timelineValue;
+    VkCommandBuffer commandBuffer;
+};
+
+struct GfxStagingRegion {
+    VkDeviceSize begin;
+    VkDeviceSize end;
+    uint64_t timelineValue;
+};
+
+struct GfxDedicatedStaging {
+    uint64_t timelineValue;
+    VkBuffer buffer;
+    VmaAllocation allocation;
+};
+
+struct GfxStagingRing {
+    VkBuffer buffer{};
+    VmaAllocation allocation{};
+    unsigned char *mapped{};
+    VkDeviceSize size{};
+    // live regions in allocation order, space is only reused once every older region has been retired.
+    std::deque<GfxStagingRegion, MemAllocator<GfxStagingRegion, MSG_GFX>> regions;
+};
+
+struct GfxUploadQueue {
+    GfxStagingRing ring;
+    UploadVector<GfxDedicatedStaging> dedicated;
+
+    VkSemaphore timeline{};
+    // value signaled by the most recent transfer submit.
+    uint64_t submittedValue{};
+    uint64_t completedValue{};
+
+    UploadVector<GfxUploadSubmission> inFlight;
+    UploadVector<VkCommandBuffer> freeCommandBuffers;
+
+    // acquires waiting to be recorded into the next frame, only needed when the queue families differ.
+    UploadVector<VkImageMemoryBarrier> pendingImageAcquires;
+    UploadVector<VkBufferMemoryBarrier> pendingBufferAcquires;
+    uint64_t pendingWaitValue{};
+};
+
+GfxUploadQueue *g_gfxUploadQueue;
+
+//===internal functions======
+static bool needs_ownership_transfer() {
+    return g_gfxDevice->transferQueueIndex != g_gfxDevice->graphicsQueueIndex;
+}
+
+template<typename T>
+static void set_release(T &barrier) {
+    barrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+    barrier.dstAccessMask = 0;
+    if (needs_ownership_transfer()) {
+        barrier.srcQueueFamilyIndex = g_gfxDevice->transferQueueIndex;
+        barrier.dstQueueFamilyIndex = g_gfxDevice->graphicsQueueIndex;
+    } else {
+        barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+        barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+    }
+}
+
+template<typename T>
+static void set_acquire(T &barrier, const VkAccessFlags dstAccessMask) {
+    barrier.srcAccessMask = 0;
+    barrier.dstAccessMask = dstAccessMask;
+    barrier.srcQueueFamilyIndex = g_gfxDevice->transferQueueIndex;
+    barrier.dstQueueFamilyIndex = g_gfxDevice->graphicsQueueIndex;
+}
+
+static uint64_t query_completed_value() {
+#if BEET_VK_COMPILE_VERSION_1_2
+    if (g_gfxUploadQueue->timeline != VK_NULL_HANDLE) {
+        vkGetSemaphoreCounterValue(g_gfxDevice->vkDevice, g_gfxUploadQueue->timeline, &g_gfxUploadQueue->completedValue);
+    }
+#endif
+    return g_gfxUploadQueue->completedValue;
+}
+
+static void wait_for_value(const uint64_t value) {
+#if BEET_VK_COMPILE_VERSION_1_2
+    VkSemaphoreWaitInfo waitInfo = {VK_STRUCTURE_TYPE_SEMAPHORE_WAIT_INFO};
+    waitInfo.semaphoreCount = 1;
+    waitInfo.pSemaphores = &g_gfxUploadQueue->timeline;
+    waitInfo.pValues = &value;
+    vkWaitSemaphores(g_gfxDevice->vkDevice, &waitInfo, UINT64_MAX);
+#endif
+    query_completed_value();
+}
+
+static VkDeviceSize align_up(const VkDeviceSize value, const VkDeviceSize alignment) {
+    return (value + alignment - 1) / alignment * alignment;
+}
+
+static void ring_retire(GfxStagingRing &ring, const uint64_t completedValue) {
+    while (!ring.regions.empty() && ring.regions.front().timelineValue <= completedValue) {
+        ring.regions.pop_front();
+    }
+}
+
+static bool ring_try_alloc(GfxStagingRing &ring, const VkDeviceSize size, const VkDeviceSize alignment, VkDeviceSize *outOffset) {
+    VkDeviceSize offset = 0;
+    if (!ring.regions.empty()) {
+        const VkDeviceSize tail = ring.regions.front().begin;
+        const VkDeviceSize head = ring.regions.back().end;
+        offset = align_up(head, alignment);
+        // the newest region starting before the oldest means the live regions wrap past the end of the ring.
+        const bool wrapped = ring.regions.back().begin < tail;
+        if (wrapped) {
+            if (offset + size > tail) {
+                return false;
+            }
+        } else if (offset + size > ring.size) {
+            // the gap left at the end is reclaimed with the region before it.
+            if (size > tail) {
+                return false;
+            }
+            offset = 0;
+        }
+    } else if (size > ring.size) {
+        return false;
+    }
+    ring.regions.push_back(GfxStagingRegion{offset, offset + size, GFX_STAGING_PENDING});
+    *outOffset = offset;
+    return true;
+}
+
+static void destroy_finished_dedicated(const uint64_t completedValue) {
+    UploadVector<GfxDedicatedStaging> &dedicated = g_gfxUploadQueue->dedicated;
+    for (size_t i = 0; i < dedicated.size();) {
+        if (dedicated[i].timelineValue <= completedValue) {
+            vmaDestroyBuffer(g_gfxDevice->vmaAllocator, dedicated[i].buffer, dedicated[i].allocation);
+            dedicated[i] = dedicated.back();
+            dedicated.pop_back();
+        } else {
+            ++i;
+        }
+    }
+}
+
+//===api=====================
+GfxStagingAlloc gfx_staging_alloc(VkDeviceSize size, VkDeviceSize alignment) {
+    ASSERT_MSG(size > 0, "Err: empty staging allocation");
+    GfxUploadQueue &queue = *g_gfxUploadQueue;
+    GfxStagingRing &ring = queue.ring;
+
+    GfxStagingAlloc staging{};
+    staging.size = size;
+    if (size > ring.size) {
+        log_verbose(MSG_GFX, "staging %llu bytes doesn't fit in the ring, creating a dedicated buffer\n", (unsigned long long) size);
+        VkBufferCreateInfo stagingBufInfo = {VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO};
+        stagingBufInfo.size = size;
+        stagingBufInfo.usage = VK_BUFFER_USAGE_TRANSFER_SRC_BIT;
+
+        VmaAllocationCreateInfo stagingBufAllocCreateInfo = {};
+        stagingBufAllocCreateInfo.usage = VMA_MEMORY_USAGE_AUTO;
+        stagingBufAllocCreateInfo.flags = VMA_ALLOCATION_CREATE_HOST_ACCESS_SEQUENTIAL_WRITE_BIT | VMA_ALLOCATION_CREATE_MAPPED_BIT;
+
+        VmaAllocationInfo stagingBufAllocInfo = {};
+        VkResult createBufferRes = vmaCreateBuffer(
+                g_gfxDevice->vmaAllocator,
+                &stagingBufInfo,
+                &stagingBufAllocCreateInfo,
+                &staging.buffer,
+                &staging.dedicatedAllocation,
+                &stagingBufAllocInfo
+        );
+        ASSERT_MSG(createBufferRes == VK_SUCCESS, "Err: Failed to create staging buffers");
+        staging.mapped = stagingBufAllocInfo.pMappedData;
+        return staging;
+    }
+
+    ring_retire(ring, query_completed_value());
+    while (!ring_try_alloc(ring, size, alignment, &staging.offset)) {
+        // full, wait for the oldest region's upload to finish.
+        const uint64_t oldest = ring.regions.front().timelineValue;
+        ASSERT_MSG(oldest != GFX_STAGING_PENDING, "Err: staging ring is full of unsubmitted uploads, requested %llu bytes", (unsigned long long) size);
+        BEET_PROFILE_SCOPE("gfx_staging_ring_wait");
+        wait_for_value(oldest);
+        ring_retire(ring, queue.completedValue);
+    }
+    staging.buffer = ring.buffer;
+    staging.mapped = ring.mapped + staging.offset;
+    return staging;
+}
+
+void gfx_staging_flush(const GfxStagingAlloc &staging) {
+    if (staging.dedicatedAllocation != VK_NULL_HANDLE) {
+        vmaFlushAllocation(g_gfxDevice->vmaAllocator, staging.dedicatedAllocation, 0, VK_WHOLE_SIZE);
+    } else {
+        vmaFlushAllocation(g_gfxDevice->vmaAllocator, g_gfxUploadQueue->ring.allocation, staging.offset, staging.size);
+    }
+}
+
+void gfx_staging_release(const GfxStagingAlloc &staging, uint64_t timelineValue) {
+    GfxUploadQueue &queue = *g_gfxUploadQueue;
+    if (staging.dedicatedAllocation != VK_NULL_HANDLE) {
+        queue.dedicated.push_back(GfxDedicatedStaging{timelineValue, staging.buffer, staging.dedicatedAllocation});
+        destroy_finished_dedicated(queue.completedValue);
+        return;
+    }
+    for (GfxStagingRegion &region: queue.ring.regions) {
+        if (region.begin == staging.offset && region.timelineValue == GFX_STAGING_PENDING) {
+            region.timelineValue = timelineValue;
+            ring_retire(queue.ring, queue.completedValue);
+            return;
+        }
+    }
+    SANITY_CHECK();
+}
+
+bool gfx_upload_async_supported() {
+    return g_gfxUploadQueue->timeline != VK_NULL_HANDLE;
+}
+
+VkCommandBuffer gfx_upload_begin_recording() {
+    ASSERT_MSG(gfx_upload_async_supported(), "Err: async uploads need timeline semaphore support");
+    VkCommandBuffer cmd = VK_NULL_HANDLE;
+    if (!g_gfxUploadQueue->freeCommandBuffers.empty()) {
+        cmd = g_gfxUploadQueue->freeCommandBuffers.back();
+        g_gfxUploadQueue->freeCommandBuffers.pop_back();
+    } else {
+        VkCommandBufferAllocateInfo commandBufferInfo = {VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO};
+        commandBufferInfo.commandPool = g_gfxDevice->vkTransferCommandPool;
+        commandBufferInfo.level = VK_COMMAND_BUFFER_LEVEL_PRIMARY;
+        commandBufferInfo.commandBufferCount = 1;
+        VkResult cmdResult = vkAllocateCommandBuffers(g_gfxDevice->vkDevice, &commandBufferInfo, &cmd);
+        ASSERT_MSG(cmdResult == VK_SUCCESS, "Err: failed to create transfer command buffer");
+    }
+
+    VkCommandBufferBeginInfo cmdBufBeginInfo = {VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO};
+    cmdBufBeginInfo.flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT;
+    vkBeginCommandBuffer(cmd, &cmdBufBeginInfo);
+    return cmd;
+}
+
+uint64_t gfx_upload_submit(VkCommandBuffer cmd, const GfxStagingAlloc &staging,
+                           const VkImageMemoryBarrier *imageBarriers, uint32_t imageBarrierCount,
+                           const VkBufferMemoryBarrier *bufferBarriers, uint32_t bufferBarrierCount) {
+    GfxUploadQueue &queue = *g_gfxUploadQueue;
+    const size_t firstImage = queue.pendingImageAcquires.size();
+    const size_t firstBuffer = queue.pendingBufferAcquires.size();
+
+    // the release barriers are built in place at the end of the pending lists, then rewritten as acquires.
+    queue.pendingImageAcquires.insert(queue.pendingImageAcquires.end(), imageBarriers, imageBarriers + imageBarrierCount);
+    queue.pendingBufferAcquires.insert(queue.pendingBufferAcquires.end(), bufferBarriers, bufferBarriers + bufferBarrierCount);
+    VkImageMemoryBarrier *images = queue.pendingImageAcquires.data() + firstImage;
+    VkBufferMemoryBarrier *buffers = queue.pendingBufferAcquires.data() + firstBuffer;
+    for (uint32_t i = 0; i < imageBarrierCount; ++i) {
+        set_release(images[i]);
+    }
+    for (uint32_t i = 0; i < bufferBarrierCount; ++i) {
+        set_release(buffers[i]);
+    }
+
+    vkCmdPipelineBarrier(
+            cmd,
+            VK_PIPELINE_STAGE_TRANSFER_BIT,
+            VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT,
+            0,
+            0, nullptr,
+            bufferBarrierCount, buffers,
+            imageBarrierCount, images);
+    vkEndCommandBuffer(cmd);
+
+    if (needs_ownership_transfer()) {
+        for (uint32_t i = 0; i < imageBarrierCount; ++i) {
+            set_acquire(images[i], imageBarriers[i].dstAccessMask);
+        }
+        for (uint32_t i = 0; i < bufferBarrierCount; ++i) {
+            set_acquire(buffers[i], bufferBarriers[i].dstAccessMask);
+        }
+    } else {
+        // same family, the release above already did the layout transition & the semaphore wait makes the writes visible.
+        queue.pendingImageAcquires.resize(firstImage);
+        queue.pendingBufferAcquires.resize(firstBuffer);
+    }
+
+    const uint64_t signalValue = ++queue.submittedValue;
+#if BEET_VK_COMPILE_VERSION_1_2
+    VkTimelineSemaphoreSubmitInfo timelineInfo = {VK_STRUCTURE_TYPE_TIMELINE_SEMAPHORE_SUBMIT_INFO};
+    timelineInfo.signalSemaphoreValueCount = 1;
+    timelineInfo.pSignalSemaphoreValues = &signalValue;
+
+    VkSubmitInfo submitInfo = {VK_STRUCTURE_TYPE_SUBMIT_INFO};
+    submitInfo.pNext = &timelineInfo;
+    submitInfo.commandBufferCount = 1;
+    submitInfo.pCommandBuffers = &cmd;
+    submitInfo.signalSemaphoreCount = 1;
+    submitInfo.pSignalSemaphores = &queue.timeline;
+    VkResult submitResult = vkQueueSubmit(g_gfxDevice->vkTransferQueue, 1, &submitInfo, VK_NULL_HANDLE);
+    ASSERT_MSG(submitResult == VK_SUCCESS, "Err: failed to submit upload [%llu]", (unsigned long long) signalValue);
+#endif
+
+    queue.inFlight.push_back(GfxUploadSubmission{signalValue, cmd});
+    gfx_staging_release(staging, signalValue);
+    queue.pendingWaitValue = signalValue;
+    return signalValue;
+}
+
+bool gfx_upload_is_complete(uint64_t ticket) {
+    return ticket <= g_gfxUploadQueue->completedValue || ticket <= query_completed_value();
+}
+
+void gfx_upload_collect() {
+    GfxUploadQueue &queue = *g_gfxUploadQueue;
+    if (queue.inFlight.empty()) {
+        return;
+    }
+    const uint64_t completed = query_completed_value();
+    ring_retire(queue.ring, completed);
+    destroy_finished_dedicated(completed);
+    // submissions signal in order, finished ones are always at the front.
+    size_t finished = 0;
+    for (; finished < queue.inFlight.size() && queue.inFlight[finished].timelineValue <= completed; ++finished) {
+        queue.freeCommandBuffers.push_back(queue.inFlight[finished].commandBuffer);
+    }
+    queue.inFlight.erase(queue.inFlight.begin(), queue.inFlight.begin() + finished);
+}
+
+uint64_t gfx_upload_record_acquires(VkCommandBuffer cmd) {
+    GfxUploadQueue &queue = *g_gfxUploadQueue;
+    if (!queue.pendingImageAcquires.empty() || !queue.pendingBufferAcquires.empty()) {
+        vkCmdPipelineBarrier(
+                cmd,
+                GFX_UPLOAD_WAIT_STAGES,
+                GFX_UPLOAD_WAIT_STAGES,
+                0,
+                0, nullptr,
+                (uint32_t) queue.pendingBufferAcquires.size(), queue.pendingBufferAcquires.data(),
+                (uint32_t) queue.pendingImageAcquires.size(), queue.pendingImageAcquires.data());
+        queue.pendingImageAcquires.clear();
+        queue.pendingBufferAcquires.clear();
+    }
+    const uint64_t waitValue = queue.pendingWaitValue;
+    queue.pendingWaitValue = 0;
+    return waitValue;
+}
+
+VkSemaphore gfx_upload_timeline() {
+    return g_gfxUploadQueue->timeline;
+}
+
+//===init & shutdown=========
+void gfx_create_upload_queue() {
+    ASSERT_MSG(g_gfxDevice->vmaAllocator, "Err: vma allocator hasn't been created yet");
+    g_gfxUploadQueue = mem_new<GfxUploadQueue>(MSG_GFX);
+
+    GfxStagingRing &ring = g_gfxUploadQueue->ring;
+    VkBufferCreateInfo ringInfo = {VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO};
+    ringInfo.size = GFX_STAGING_RING_SIZE;
+    ringInfo.usage = VK_BUFFER_USAGE_TRANSFER_SRC_BIT;
+
+    VmaAllocationCreateInfo ringAllocCreateInfo = {};
+    ringAllocCreateInfo.usage = VMA_MEMORY_USAGE_AUTO;
+    ringAllocCreateInfo.flags = VMA_ALLOCATION_CREATE_HOST_ACCESS_SEQUENTIAL_WRITE_BIT | VMA_ALLOCATION_CREATE_MAPPED_BIT;
+
+    VmaAllocationInfo ringAllocInfo = {};
+    VkResult ringResult = vmaCreateBuffer(g_gfxDevice->vmaAllocator, &ringInfo, &ringAllocCreateInfo, &ring.buffer, &ring.allocation, &ringAllocInfo);
+    ASSERT_MSG(ringResult == VK_SUCCESS, "Err: failed to create staging ring");
+    ring.mapped = (unsigned char *) ringAllocInfo.pMappedData;
+    ring.size = GFX_STAGING_RING_SIZE;
+
+    if (!g_gfxDevice->supportsTimelineSemaphore) {
+        log_warning(MSG_GFX, "timeline semaphores aren't supported, uploads will block on the graphics queue\n");
+        return;
+    }
+#if BEET_VK_COMPILE_VERSION_1_2
+    VkSemaphoreTypeCreateInfo timelineInfo = {VK_STRUCTURE_TYPE_SEMAPHORE_TYPE_CREATE_INFO};
+    timelineInfo.semaphoreType = VK_SEMAPHORE_TYPE_TIMELINE;
+    timelineInfo.initialValue = 0;
+
+    VkSemaphoreCreateInfo semaphoreInfo = {VK_STRUCTURE_TYPE_SEMAPHORE_CREATE_INFO};
+    semaphoreInfo.pNext = &timelineInfo;
+    VkResult semaphoreResult = vkCreateSemaphore(g_gfxDevice->vkDevice, &semaphoreInfo, nullptr, &g_gfxUploadQueue->timeline);
+    ASSERT_MSG(semaphoreResult == VK_SUCCESS, "Err: failed to create upload timeline semaphore");
+#endif
+}
+
+void gfx_cleanup_upload_queue() {
+    GfxUploadQueue &queue = *g_gfxUploadQueue;
+    if (queue.timeline != VK_NULL_HANDLE) {
+        wait_for_value(queue.submittedValue);
+        gfx_upload_collect();
+        ASSERT_MSG(queue.inFlight.empty(), "Err: %zu uploads still in flight", queue.inFlight.size());
+
+        if (!queue.freeCommandBuffers.empty()) {
+            vkFreeCommandBuffers(g_gfxDevice->vkDevice, g_gfxDevice->vkTransferCommandPool,
+                                 (uint32_t) queue.freeCommandBuffers.size(), queue.freeCommandBuffers.data());
+        }
+        vkDestroySemaphore(g_gfxDevice->vkDevice, queue.timeline, nullptr);
+    }
+    ASSERT_MSG(queue.dedicated.empty(), "Err: %zu dedicated staging buffers were never released", queue.dedicated.size());
+    ring_retire(queue.ring, queue.completedValue);
+    ASSERT_MSG(queue.ring.regions.empty(), "Err: %zu staging regions were never released", queue.ring.regions.size());
+    vmaDestroyBuffer(g_gfxDevice->vmaAllocator, queue.ring.buffer, queue.ring.allocation);
+    mem_delete(g_gfxUploadQueue);
+    g_gfxUploadQueue = nullptr;
+}
@@ -5,10 +5,17 @@
 #include <gfx/gfx_font.h>
 #include <gfx/vulkan_platform_defines.h>
 #include <gfx/gfx_samplers.h>
+#include <gfx/gfx_timestamps.h>
+#include <gfx/gfx_stats.h>
+#include <gfx/gfx_resource_db.h>
+#include <gfx/gfx_deletion_queue.h>
+#include <gfx/gfx_upload.h>
 
 #include <shared/log.h>
 #include <shared/assert.h>
 #include <shared/bit_utils.h>
+#include <shared/profiler.h>
+#include <shared/mem_tracker.h>
 
 #include <unordered_map>
 
@@ -182,22 +189,34 @@ void destroy_swapchain() {
         for (uint32_t i = 0; i < g_gfxDevice->swapchainImageViewCount; ++i) {
             vkDestroyImageView(g_gfxDevice->vkDevice, g_gfxDevice->vkSwapchainImageViews[i], nullptr);
         }
+        mem_delete_array(g_gfxDevice->vkSwapchainImageViews, g_gfxDevice->swapchainImageViewCount);
         g_gfxDevice->swapchainImageViewCount = 0;
-        delete[] g_gfxDevice->vkSwapchainImageViews;
         g_gfxDevice->vkSwapchainImageViews = nullptr;
     }
 }
 
-void gfx_command_submit(const VkCommandBuffer &cmdBuffer) {
-    const uint32_t submitWaitSemaphoresCount = 1;
-    VkSemaphore submitWaitSemaphores[submitWaitSemaphoresCount] = {g_gfxDevice->vkSemaphoreImageAvailable};
+void gfx_command_submit(const VkCommandBuffer &cmdBuffer, const uint64_t uploadWaitValue) {
+    // the upload timeline is only waited on when the frame uses something uploaded since the last submit.
+    const uint32_t submitWaitSemaphoresCount = uploadWaitValue > 0 ? 2 : 1;
+    VkSemaphore submitWaitSemaphores[2] = {g_gfxDevice->vkSemaphoreImageAvailable, gfx_upload_timeline()};
+    // binary semaphores ignore their wait value.
+    const uint64_t submitWaitValues[2] = {0, uploadWaitValue};
 
     const uint32_t submitSignalSemaphoresCount = 1;
     VkSemaphore submitSignalSemaphores[submitSignalSemaphoresCount] = {g_gfxDevice->vkSemaphoreRenderFinished};
 
-    VkPipelineStageFlags submitWaitStages[] = {VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT};
+    VkPipelineStageFlags submitWaitStages[] = {VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT, GFX_UPLOAD_WAIT_STAGES};
     VkSubmitInfo submitInfo = {VK_STRUCTURE_TYPE_SUBMIT_INFO};
 
+#if BEET_VK_COMPILE_VERSION_1_2
+    VkTimelineSemaphoreSubmitInfo timelineInfo = {VK_STRUCTURE_TYPE_TIMELINE_SEMAPHORE_SUBMIT_INFO};
+    timelineInfo.waitSemaphoreValueCount = submitWaitSemaphoresCount;
+    timelineInfo.pWaitSemaphoreValues = submitWaitValues;
+    if (uploadWaitValue > 0) {
+        submitInfo.pNext = &timelineInfo;
+    }
+#endif
+
     submitInfo.waitSemaphoreCount = submitWaitSemaphoresCount;
     submitInfo.pWaitSemaphores = submitWaitSemaphores;
     submitInfo.pWaitDstStageMask = submitWaitStages;
@@ -360,12 +379,12 @@ void create_swapchain_image_views(const VkFormat selectedSurfaceFormat) {
     uint32_t swapchainImagesCount = 0;
     vkGetSwapchainImagesKHR(g_gfxDevice->vkDevice, g_gfxDevice->vkSwapchain, &swapchainImagesCount, nullptr);
 
-    VkImage *swapchainImages = new VkImage[swapchainImagesCount];
+    VkImage *swapchainImages = mem_new_array<VkImage>(MSG_GFX, swapchainImagesCount);
     vkGetSwapchainImagesKHR(g_gfxDevice->vkDevice, g_gfxDevice->vkSwapchain, &swapchainImagesCount, swapchainImages);
 
     g_gfxDevice->swapchainImageViewCount = swapchainImagesCount;
     VkImageViewCreateInfo swapchainImageViewInfo = {VK_STRUCTURE_TYPE_IMAGE_VIEW_CREATE_INFO};
-    g_gfxDevice->vkSwapchainImageViews = new VkImageView[g_gfxDevice->swapchainImageViewCount];
+    g_gfxDevice->vkSwapchainImageViews = mem_new_array<VkImageView>(MSG_GFX, g_gfxDevice->swapchainImageViewCount);
 
     for (uint32_t i = 0; i < swapchainImagesCount; ++i) {
         swapchainImageViewInfo.image = swapchainImages[i];
@@ -383,7 +402,7 @@ void create_swapchain_image_views(const VkFormat selectedSurfaceFormat) {
         vkCreateImageView(g_gfxDevice->vkDevice, &swapchainImageViewInfo, nullptr,
                           &g_gfxDevice->vkSwapchainImageViews[i]);
     }
-    delete[] swapchainImages;
+    mem_delete_array(swapchainImages, swapchainImagesCount);
 }
 
 void create_depth_buffer(const VkFormat &selectedDepthFormat) {
@@ -728,6 +747,16 @@ void gfx_create_queues() {
     VkPhysicalDeviceFeatures2 deviceFeatures = {VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_FEATURES_2};
     deviceFeatures.features.samplerAnisotropy = VK_TRUE;
 
+#if BEET_VK_COMPILE_VERSION_1_2
+    // timeline semaphores are core & always supported from 1.2, they track async transfer queue uploads.
+    VkPhysicalDeviceVulkan12Features vulkan12Features = {VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_VULKAN_1_2_FEATURES};
+    vulkan12Features.timelineSemaphore = VK_TRUE;
+    if (g_vulkanProperties->selectedPhysicalDevice.apiVersion >= BEET_VK_API_VERSION_1_2) {
+        deviceFeatures.pNext = &vulkan12Features;
+        g_gfxDevice->supportsTimelineSemaphore = true;
+    }
+#endif
+
     uint32_t deviceExtensionCount = 0;
     const uint32_t maxSupportedDeviceExtensions = 2;
     const char *enabledDeviceExtensions[maxSupportedDeviceExtensions];
@@ -839,7 +868,16 @@ void gfx_create_command_pool() {
     ASSERT_MSG(cmdImmediateBufferResult == VK_SUCCESS, "Err: failed to create immediate command buffer");
 
     //===transfer================
-    //TODO:GFX: transfer pool command buffer for async.
+    // command buffers are allocated on demand by gfx_upload, one per in-flight upload.
+    commandPoolInfo.queueFamilyIndex = g_gfxDevice->transferQueueIndex;
+    VkResult transferPoolResult =
+            vkCreateCommandPool(
+                    g_gfxDevice->vkDevice,
+                    &commandPoolInfo,
+                    nullptr,
+                    &g_gfxDevice->vkTransferCommandPool
+            );
+    ASSERT_MSG(transferPoolResult == VK_SUCCESS, "Err: failed to create transfer command pool");
 }
 
 void gfx_cleanup_command_pool() {
@@ -870,6 +908,9 @@ void gfx_cleanup_command_pool() {
     {
         vkDestroyCommandPool(g_gfxDevice->vkDevice, g_gfxDevice->vkGraphicsCommandPool, nullptr);
         g_gfxDevice->vkGraphicsCommandPool = VK_NULL_HANDLE;
+
+        vkDestroyCommandPool(g_gfxDevice->vkDevice, g_gfxDevice->vkTransferCommandPool, nullptr);
+        g_gfxDevice->vkTransferCommandPool = VK_NULL_HANDLE;
     }
 }
 
@@ -985,7 +1026,8 @@ void gfx_reset_graphics_command_buffer() {
     vkResetCommandBuffer(g_gfxDevice->vkGraphicsCommandBuffers[g_gfxDevice->nextCommandBufferIndex], 0);
 }
 
-void gfx_update(const double &deltaTime) {
+void gfx_update(const double &deltaTime, GfxParallelFor parallelFor) {
+    BEET_PROFILE_SCOPE("gfx_update");
     static double timePassed{};
     timePassed += deltaTime;
 
@@ -999,20 +1041,35 @@ void gfx_update(const double &deltaTime) {
 
     gfx_next_frame();
     gfx_sync();
+    gfx_deletion_queue_flush(g_gfxDevice->nextCommandBufferIndex);
+    gfx_upload_collect();
+    gfx_timestamps_collect();
+    gfx_db_commit_concurrent_adds();
+    gfx_stats_frame()->worldMatrixUpdates += gfx_db_update_world_matrices(parallelFor);
 
     VkCommandBuffer cmdBuffer = gfx_graphics_command_buffer();
     gfx_reset_graphics_command_buffer();
 
+    uint64_t uploadWaitValue = 0;
     begin_command_recording(cmdBuffer);
     {
+        gfx_timestamps_reset(cmdBuffer);
+        uploadWaitValue = gfx_upload_record_acquires(cmdBuffer);
+
+        gfx_timestamps_begin_pass(cmdBuffer, GfxTimestampPass::LitPass);
         gfx_lit_record_render_pass(cmdBuffer);
+        gfx_timestamps_end_pass(cmdBuffer, GfxTimestampPass::LitPass);
+
+        gfx_timestamps_begin_pass(cmdBuffer, GfxTimestampPass::FontPass);
         gfx_font_record_render_pass(cmdBuffer);
+        gfx_timestamps_end_pass(cmdBuffer, GfxTimestampPass::FontPass);
     }
     end_command_recording(cmdBuffer);
 
-    gfx_command_submit(cmdBuffer);
+    gfx_command_submit(cmdBuffer, uploadWaitValue);
 
     preset_queue();
+    gfx_stats_end_frame();
 }
 
 
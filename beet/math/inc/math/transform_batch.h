@@ -0,0 +1,26 @@
+#ifndef BEETROOT_TRANSFORM_BATCH_H
+#define BEETROOT_TRANSFORM_BATCH_H
+
+#include <math/mat4.h>
+#include <math/vec4.h>
+
+#include <cstdint>
+
+// transform components as separate streams, rotation is euler angles in radians as used by quat(vec3f).
+struct TransformStreams {
+    const float *positionX;
+    const float *positionY;
+    const float *positionZ;
+    const float *rotationX;
+    const float *rotationY;
+    const float *rotationZ;
+    const float *scaleX;
+    const float *scaleY;
+    const float *scaleZ;
+};
+
+// writes translate(position) * toMat4(quat(rotation)) * scale(scale) for count transforms into a contiguous mat4 array.
+// the maths runs over fixed size blocks of plain float arrays so the compiler can vectorise it.
+void transform_batch_world_matrices(const TransformStreams &streams, uint32_t count, mat4 *outWorldMatrices);
+
+#endif //BEETROOT_TRANSFORM_BATCH_H
@@ -0,0 +1,76 @@
+#include <math/transform_batch.h>
+
+#include <cmath>
+
+//===defines=================
+#define TRANSFORM_BATCH_BLOCK 64u
+
+//===internal functions======
+static void compose_block(const TransformStreams &streams, const uint32_t first, const uint32_t count, mat4 *outWorldMatrices) {
+    // half angle sin & cos per axis, kept apart so the arithmetic loop below has no calls in it.
+    float cx[TRANSFORM_BATCH_BLOCK], cy[TRANSFORM_BATCH_BLOCK], cz[TRANSFORM_BATCH_BLOCK];
+    float sx[TRANSFORM_BATCH_BLOCK], sy[TRANSFORM_BATCH_BLOCK], sz[TRANSFORM_BATCH_BLOCK];
+    // rotation & scale columns of every transform in the block, one array per matrix element.
+    float m00[TRANSFORM_BATCH_BLOCK], m01[TRANSFORM_BATCH_BLOCK], m02[TRANSFORM_BATCH_BLOCK];
+    float m10[TRANSFORM_BATCH_BLOCK], m11[TRANSFORM_BATCH_BLOCK], m12[TRANSFORM_BATCH_BLOCK];
+    float m20[TRANSFORM_BATCH_BLOCK], m21[TRANSFORM_BATCH_BLOCK], m22[TRANSFORM_BATCH_BLOCK];
+
+    const float *rx = streams.rotationX + first;
+    const float *ry = streams.rotationY + first;
+    const float *rz = streams.rotationZ + first;
+    for (uint32_t i = 0; i < count; ++i) {
+        cx[i] = cosf(rx[i] * 0.5f);
+        sx[i] = sinf(rx[i] * 0.5f);
+        cy[i] = cosf(ry[i] * 0.5f);
+        sy[i] = sinf(ry[i] * 0.5f);
+        cz[i] = cosf(rz[i] * 0.5f);
+        sz[i] = sinf(rz[i] * 0.5f);
+    }
+
+    const float *scaleX = streams.scaleX + first;
+    const float *scaleY = streams.scaleY + first;
+    const float *scaleZ = streams.scaleZ + first;
+    for (uint32_t i = 0; i < count; ++i) {
+        // euler to quaternion, matches glm::qua(vec3 eulerAngles).
+        const float qw = cx[i] * cy[i] * cz[i] + sx[i] * sy[i] * sz[i];
+        const float qx = sx[i] * cy[i] * cz[i] - cx[i] * sy[i] * sz[i];
+        const float qy = cx[i] * sy[i] * cz[i] + sx[i] * cy[i] * sz[i];
+        const float qz = cx[i] * cy[i] * sz[i] - sx[i] * sy[i] * cz[i];
+
+        // quaternion to rotation matrix, matches glm::mat3_cast, columns scaled by the per axis scale.
+        const float xx = qx * qx, yy = qy * qy, zz = qz * qz;
+        const float xy = qx * qy, xz = qx * qz, yz = qy * qz;
+        const float wx = qw * qx, wy = qw * qy, wz = qw * qz;
+
+        m00[i] = (1.0f - 2.0f * (yy + zz)) * scaleX[i];
+        m01[i] = (2.0f * (xy + wz)) * scaleX[i];
+        m02[i] = (2.0f * (xz - wy)) * scaleX[i];
+
+        m10[i] = (2.0f * (xy - wz)) * scaleY[i];
+        m11[i] = (1.0f - 2.0f * (xx + zz)) * scaleY[i];
+        m12[i] = (2.0f * (yz + wx)) * scaleY[i];
+
+        m20[i] = (2.0f * (xz + wy)) * scaleZ[i];
+        m21[i] = (2.0f * (yz - wx)) * scaleZ[i];
+        m22[i] = (1.0f - 2.0f * (xx + yy)) * scaleZ[i];
+    }
+
+    const float *px = streams.positionX + first;
+    const float *py = streams.positionY + first;
+    const float *pz = streams.positionZ + first;
+    mat4 *out = outWorldMatrices + first;
+    for (uint32_t i = 0; i < count; ++i) {
+        out[i][0] = vec4(m00[i], m01[i], m02[i], 0.0f);
+        out[i][1] = vec4(m10[i], m11[i], m12[i], 0.0f);
+        out[i][2] = vec4(m20[i], m21[i], m22[i], 0.0f);
+        out[i][3] = vec4(px[i], py[i], pz[i], 1.0f);
+    }
+}
+
+//===api=====================
+void transform_batch_world_matrices(const TransformStreams &streams, uint32_t count, mat4 *outWorldMatrices) {
+    for (uint32_t first = 0; first < count; first += TRANSFORM_BATCH_BLOCK) {
+        const uint32_t remaining = count - first;
+        compose_block(streams, first, remaining < TRANSFORM_BATCH_BLOCK ? remaining : TRANSFORM_BATCH_BLOCK, outWorldMatrices);
+    }
+}
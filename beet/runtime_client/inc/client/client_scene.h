@@ -0,0 +1,8 @@
+#ifndef BEETROOT_CLIENT_SCENE_H
+#define BEETROOT_CLIENT_SCENE_H
+
+// restores a scene written by the pipeline (pipeline/scene_writer.h) into the gfx db & ecs.
+// returns false, having created nothing, when the file is missing or was written by another version.
+bool client_load_scene(const char *path);
+
+#endif //BEETROOT_CLIENT_SCENE_H
@@ -1,86 +1,216 @@
 #include <core/engine.h>
+#include <core/engine_jobs.h>
 #include <core/window.h>
 #include <core/time.h>
 #include <core/input.h>
 
+#include <shared/profiler.h>
+#include <shared/log.h>
+#include <shared/mem_tracker.h>
+#include <shared/ecs.h>
+
 #include <gfx/gfx_interface.h>
 #include <gfx/gfx_lit.h>
 #include <gfx/gfx_font.h>
 #include <gfx/gfx_resource_db.h>
 #include <gfx/gfx_texture.h>
 #include <gfx/gfx_mesh.h>
+#include <gfx/gfx_timestamps.h>
+#include <gfx/gfx_stats.h>
+#include <gfx/gfx_asset_cache.h>
+#include <gfx/gfx_deletion_queue.h>
+#include <gfx/gfx_upload.h>
 
 #include <client/script_editor_camera.h>
 #include <client/client_entity_builder.h>
+#include <client/client_scene.h>
+
+#include <cstdlib>
+#include <cstring>
+
+// set with -gfx_stats <frames>, 0 only logs the stats of the last frame at shutdown.
+static uint32_t s_gfxStatsLogInterval = 0;
+
+// initial gfx db table sizes, each one can be overridden with -db_<table> <slots>.
+static GfxDbConfig s_gfxDbConfig = {};
+
+struct GfxDbConfigFlag {
+    const char *flag;
+    uint32_t GfxDbConfig::*slots;
+};
+
+static const GfxDbConfigFlag s_gfxDbConfigFlags[] = {
+        {"-db_cameras",         &GfxDbConfig::cameras},
+        {"-db_transforms",      &GfxDbConfig::transforms},
+        {"-db_ui_transforms",   &GfxDbConfig::uiTransforms},
+        {"-db_textures",        &GfxDbConfig::textures},
+        {"-db_meshes",          &GfxDbConfig::meshes},
+        {"-db_descriptor_sets", &GfxDbConfig::descriptorSets},
+        {"-db_lit_materials",   &GfxDbConfig::litMaterials},
+        {"-db_font_materials",  &GfxDbConfig::fontMaterials},
+};
+
+// supports: -gfx_stats <frames> -db_<table> <slots>
+void client_apply_commandline(int32_t argc, char **argv) {
+    for (int32_t i = 1; i < argc; ++i) {
+        if (i + 1 >= argc) {
+            break;
+        }
+        if (strcmp(argv[i], "-gfx_stats") == 0) {
+            s_gfxStatsLogInterval = (uint32_t) strtoul(argv[++i], nullptr, 10);
+            continue;
+        }
+        for (const GfxDbConfigFlag &configFlag: s_gfxDbConfigFlags) {
+            if (strcmp(argv[i], configFlag.flag) == 0) {
+                s_gfxDbConfig.*configFlag.slots = (uint32_t) strtoul(argv[++i], nullptr, 10);
+                break;
+            }
+        }
+    }
+}
+
+static void client_gfx_db_create() {
+    gfx_db_create(s_gfxDbConfig);
+}
 
 void client_setup_system_orders() {
-    engine_register_system_create(0, window_create);
-    engine_register_system_create(1, time_create);
-    engine_register_system_create(2, input_create);
-    engine_register_system_create(3, gfx_db_create);
-    engine_register_system_create(4, []() {
+    engine_register_system_create(0, "window_create", window_create);
+    engine_register_system_create(1, "time_create", time_create);
+    engine_register_system_create(2, "input_create", input_create);
+    engine_register_system_create(3, "gfx_db_create", client_gfx_db_create);
+    engine_register_system_create(4, "ecs_create", ecs_create);
+    engine_register_system_create(5, "gfx_create", []() {
         gfx_create();
+        gfx_create_stats();
+        gfx_stats_set_log_interval(s_gfxStatsLogInterval);
         gfx_create_instance();
         window_create_render_surface(gfx_instance(), gfx_surface());
         gfx_create_debug_callbacks();
         gfx_create_physical_device();
         gfx_create_queues();
         gfx_create_command_pool();
+        gfx_create_timestamps();
         gfx_create_samplers();
         gfx_create_allocator();
+        gfx_create_deletion_queue();
+        gfx_create_upload_queue();
+        gfx_create_asset_cache();
         gfx_create_lit_descriptors();
         gfx_create_font_descriptors();
         gfx_create_swapchain();
     });
-    engine_register_system_create(5, client_build_entities);
+    engine_register_system_create(6, "client_load_scene", []() {
+        // the pipeline writes the default scene, building it in code is the fallback until it has run.
+        if (!client_load_scene("../res/scenes/default.bscene")) {
+            client_build_entities();
+        }
+    });
 
-    engine_register_system_update(0, time_tick);
-    engine_register_system_update(1, []() { input_set_time(time_current()); });
-    engine_register_system_update(2, window_update);
-    engine_register_system_update(3, input_update);
-    engine_register_system_update(4, script_update_editor_camera);
-    engine_register_system_update(5, []() { gfx_update(time_delta()); });
+    const uint64_t gfxReadAccess = SYSTEM_ACCESS_TIME | SYSTEM_ACCESS_WINDOW |
+                                   SYSTEM_ACCESS_TRANSFORM | SYSTEM_ACCESS_UI_TRANSFORM | SYSTEM_ACCESS_CAMERA |
+                                   SYSTEM_ACCESS_ENTITY | SYSTEM_ACCESS_MATERIAL | SYSTEM_ACCESS_MESH | SYSTEM_ACCESS_TEXTURE;
+    engine_register_system_update(0, SystemDesc{"time_tick", time_tick, SYSTEM_ACCESS_NONE, SYSTEM_ACCESS_TIME, false});
+    engine_register_system_update(1, SystemDesc{"input_set_time", []() { input_set_time(time_current()); }, SYSTEM_ACCESS_TIME, SYSTEM_ACCESS_INPUT, false});
+    engine_register_system_update(2, SystemDesc{"window_update", window_update, SYSTEM_ACCESS_NONE, SYSTEM_ACCESS_WINDOW | SYSTEM_ACCESS_INPUT, true});
+    engine_register_system_update(3, SystemDesc{"input_update", input_update, SYSTEM_ACCESS_NONE, SYSTEM_ACCESS_INPUT, false});
+    engine_register_system_update(4, SystemDesc{"script_update_editor_camera", script_update_editor_camera, SYSTEM_ACCESS_TIME | SYSTEM_ACCESS_INPUT | SYSTEM_ACCESS_ENTITY, SYSTEM_ACCESS_WINDOW | SYSTEM_ACCESS_TRANSFORM, true});
+
+    engine_register_system_render(0, SystemDesc{"gfx_update", []() { gfx_update(time_delta(), engine_job_parallel_for); }, gfxReadAccess, SYSTEM_ACCESS_GFX, true});
 
     //executed as reverse iter
-    engine_register_system_cleanup(0, window_cleanup);
-    engine_register_system_cleanup(1, time_cleanup);
-    engine_register_system_cleanup(2, input_cleanup);
-    engine_register_system_cleanup(3, gfx_db_cleanup);
-    engine_register_system_cleanup(4, []() {
+    engine_register_system_cleanup(0, "window_cleanup", window_cleanup);
+    engine_register_system_cleanup(1, "time_cleanup", time_cleanup);
+    engine_register_system_cleanup(2, "input_cleanup", input_cleanup);
+    engine_register_system_cleanup(3, "gfx_db_cleanup", gfx_db_cleanup);
+    engine_register_system_cleanup(4, "ecs_cleanup", ecs_cleanup);
+    engine_register_system_cleanup(5, "gfx_cleanup", []() {
         gfx_cleanup_swapchain();
+        gfx_cleanup_deletion_queue();
+        gfx_cleanup_upload_queue();
         gfx_cleanup_font_descriptors();
         gfx_cleanup_lit_descriptors();
+        gfx_cleanup_asset_cache();
 
-        for (uint32_t i = 0; i < gfx_db_get_mesh_count(); ++i) {
-            gfx_cleanup_mesh(*gfx_db_get_mesh(i));
+        for (uint32_t i = 0; i < gfx_db_get_mesh_slot_count(); ++i) {
+            GfxMesh *mesh = gfx_db_get_mesh_at_slot(i);
+            if (mesh != nullptr) {
+                gfx_cleanup_mesh(*mesh);
+            }
         }
-        for (uint32_t i = 0; i < gfx_db_get_texture_count(); ++i) {
-            gfx_cleanup_texture(*gfx_db_get_texture(i));
+        for (uint32_t i = 0; i < gfx_db_get_texture_slot_count(); ++i) {
+            GfxTexture *texture = gfx_db_get_texture_at_slot(i);
+            if (texture != nullptr) {
+                gfx_cleanup_texture(*texture);
+            }
         }
 
         gfx_cleanup_allocator();
         gfx_cleanup_samplers();
+        gfx_cleanup_timestamps();
         gfx_cleanup_command_pool();
         gfx_cleanup_queues();
         gfx_cleanup_physical_device();
         gfx_cleanup_debug_callbacks();
         gfx_cleanup_surface();
         gfx_cleanup_instance();
+        gfx_cleanup_stats();
         gfx_cleanup();
         gfx_db_cleanup();
     });
 }
 
-int main() {
+void client_setup_headless_system_orders() {
+    // no window, surface or gfx device, just the simulation side of the frame loop.
+    engine_register_system_create(0, "time_create", time_create);
+    engine_register_system_create(1, "input_create", input_create);
+    engine_register_system_create(2, "gfx_db_create", client_gfx_db_create);
+    engine_register_system_create(3, "ecs_create", ecs_create);
+
+    engine_register_system_update(0, SystemDesc{"time_tick", time_tick, SYSTEM_ACCESS_NONE, SYSTEM_ACCESS_TIME, false});
+    engine_register_system_update(1, SystemDesc{"input_set_time", []() { input_set_time(time_current()); }, SYSTEM_ACCESS_TIME, SYSTEM_ACCESS_INPUT, false});
+    engine_register_system_update(2, SystemDesc{"input_update", input_update, SYSTEM_ACCESS_NONE, SYSTEM_ACCESS_INPUT, false});
+
+    //executed as reverse iter
+    engine_register_system_cleanup(0, "time_cleanup", time_cleanup);
+    engine_register_system_cleanup(1, "input_cleanup", input_cleanup);
+    engine_register_system_cleanup(2, "gfx_db_cleanup", gfx_db_cleanup);
+    engine_register_system_cleanup(3, "ecs_cleanup", ecs_cleanup);
+}
+
+int main(int argc, char **argv) {
     engine_create();
-    client_setup_system_orders();
+    engine_apply_commandline(argc, argv);
+    client_apply_commandline(argc, argv);
+    if (engine_is_headless()) {
+        client_setup_headless_system_orders();
+    } else {
+        client_setup_system_orders();
+    }
     engine_system_create();
+#if BEET_DEBUG
+    engine_export_system_graph("client_system_graph.dot");
+#endif
 
     while (engine_is_open()) {
         engine_system_update();
     }
 
+    mem_tracker_log();
+    if (!engine_is_headless()) {
+        if (gfx_timestamps_supported()) {
+            log_info(MSG_CLIENT, "gpu lit pass: %.3fms font pass: %.3fms\n",
+                     gfx_timestamps_pass_ms(GfxTimestampPass::LitPass), gfx_timestamps_pass_ms(GfxTimestampPass::FontPass));
+        }
+        gfx_stats_log();
+        gfx_stats_log_memory_budgets();
+    }
+#if BEET_PROFILE
+    const uint32_t lastFrame = profiler_frame_index();
+    profiler_export_chrome_trace("client_trace.json", lastFrame > 120 ? lastFrame - 120 : 0, lastFrame);
+#endif
     engine_system_cleanup();
+    // after cleanup so the cleanup systems have a sample too.
+    engine_log_system_timings();
     engine_cleanup();
     return 0;
 }
@@ -1,51 +1,51 @@
 #include <client/client_entity_builder.h>
 
+#include <core/engine_jobs.h>
+
 #include <gfx/gfx_lit.h>
 #include <gfx/gfx_font.h>
-#include <gfx/gfx_texture.h>
+#include <gfx/gfx_asset_cache.h>
 #include <gfx/gfx_mesh.h>
 #include <gfx/gfx_resource_db.h>
 
+#include <shared/ecs.h>
+
 void build_primary_camera_entity() {
     Camera camera{};
     Transform transform{};
     transform.position = vec3f{0.0f, 0.0f, -1.0f};
 
-    CameraEntity cameraEntity{};
-    cameraEntity.transformIndex = gfx_db_add_transform(transform);
-    cameraEntity.cameraIndex = gfx_db_add_camera(camera);
-    gfx_db_add_camera_entity(cameraEntity);
+    const Entity cameraEntity = ecs_create_entity();
+    ecs_add(cameraEntity, TransformComponent{gfx_db_add_transform(transform)});
+    ecs_add(cameraEntity, CameraComponent{gfx_db_add_camera(camera)});
 }
 
-void build_lit_entities() {
-    uint32_t defaultMesh{};
-    uint32_t defaultMaterial{};
+void build_lit_entities(const DbHandle uvTestTexture) {
+    DbHandle defaultMesh{};
+    DbHandle defaultMaterial{};
     {
-        GfxTexture uvTestTexture{};
-        gfx_create_texture_immediate("../res/textures/UV_Grid/UV_Grid_test.dds", uvTestTexture);
 
         VkDescriptorSet descriptorSet;
-        gfx_lit_update_material_descriptor(descriptorSet, uvTestTexture);
+        gfx_lit_update_material_descriptor(descriptorSet, *gfx_db_get_texture(uvTestTexture));
 
         LitMaterial material{};
-        material.descriptorSetIndex = gfx_db_add_descriptor_set(descriptorSet);
-        material.albedoIndex = gfx_db_add_texture(uvTestTexture);
+        material.descriptorSetHandle = gfx_db_add_descriptor_set(descriptorSet);
+        material.albedoHandle = uvTestTexture;
 
         Transform transform{};
         transform.position.y = -2;
         transform.position.z = -8;
 
         GfxMesh mesh{};
-        gfx_create_cube_immediate(mesh);
+        gfx_create_mesh_async(gfx_cube_raw_mesh(), mesh);
 
         defaultMesh = gfx_db_add_mesh(mesh);
         defaultMaterial = gfx_db_add_lit_material(material);
 
-        LitEntity defaultCube{};
-        defaultCube.transformIndex = gfx_db_add_transform(transform);
-        defaultCube.meshIndex = defaultMesh;
-        defaultCube.materialIndex = defaultMaterial;
-        gfx_db_add_lit_entity(defaultCube);
+        const Entity defaultCube = ecs_create_entity();
+        ecs_add(defaultCube, TransformComponent{gfx_db_add_transform(transform)});
+        ecs_add(defaultCube, MeshComponent{defaultMesh});
+        ecs_add(defaultCube, LitMaterialComponent{defaultMaterial});
     }
     {
         Transform transform{};
@@ -53,25 +53,22 @@ void build_lit_entities() {
         transform.position.y = 1;
         transform.position.z = -12;
 
-        LitEntity defaultCube{};
-        defaultCube.transformIndex = gfx_db_add_transform(transform);
-        defaultCube.meshIndex = defaultMesh;
-        defaultCube.materialIndex = defaultMaterial;
-        gfx_db_add_lit_entity(defaultCube);
+        const Entity defaultCube = ecs_create_entity();
+        ecs_add(defaultCube, TransformComponent{gfx_db_add_transform(transform)});
+        ecs_add(defaultCube, MeshComponent{defaultMesh});
+        ecs_add(defaultCube, LitMaterialComponent{defaultMaterial});
     }
 }
 
-void build_font_entities(){
+void build_font_entities(const DbHandle fontAtlasTexture){
     {
-        GfxTexture fontAtlasTexture{};
-        gfx_create_texture_immediate("../res/fonts/JetBrainsMono/JetBrainsMono-Regular.dds", fontAtlasTexture);
 
         VkDescriptorSet descriptorSet;
-        gfx_font_update_material_descriptor(descriptorSet, fontAtlasTexture);
+        gfx_font_update_material_descriptor(descriptorSet, *gfx_db_get_texture(fontAtlasTexture));
 
         FontMaterial material{}; // TODO Update with font material
-        material.descriptorSetIndex = gfx_db_add_descriptor_set(descriptorSet); // TODO Update with font update set
-        material.atlasIndex = gfx_db_add_texture(fontAtlasTexture);
+        material.descriptorSetHandle = gfx_db_add_descriptor_set(descriptorSet); // TODO Update with font update set
+        material.atlasHandle = fontAtlasTexture;
 
         UiTransform transform{};
         transform.position.x = -.5;
@@ -82,22 +79,29 @@ void build_font_entities(){
         transform.size.y = 400;
 
         GfxMesh mesh{};
-        gfx_create_plane_immediate(mesh);
+        gfx_create_mesh_async(gfx_plane_raw_mesh(), mesh);
 
-        uint32_t planeMeshIdx = gfx_db_add_mesh(mesh);
-        uint32_t fontMaterialIdx = gfx_db_add_font_material(material); // TODO Update with font material
+        DbHandle planeMeshHandle = gfx_db_add_mesh(mesh);
+        DbHandle fontMaterialHandle = gfx_db_add_font_material(material); // TODO Update with font material
 
-        FontEntity defaultCube{};
-        defaultCube.uiTransformIndex = gfx_db_add_ui_transform(transform);
-        defaultCube.meshIndex = planeMeshIdx;
-        defaultCube.materialIndex = fontMaterialIdx;
-        gfx_db_add_font_entity(defaultCube);
+        const Entity defaultText = ecs_create_entity();
+        ecs_add(defaultText, UiTransformComponent{gfx_db_add_ui_transform(transform)});
+        ecs_add(defaultText, MeshComponent{planeMeshHandle});
+        ecs_add(defaultText, FontMaterialComponent{fontMaterialHandle});
     }
 }
 
 void client_build_entities() {
+    // every texture is loaded up front in one batch, rather than one blocking upload per entity.
+    const char *texturePaths[] = {
+            "../res/textures/UV_Grid/UV_Grid_test.dds",
+            "../res/fonts/JetBrainsMono/JetBrainsMono-Regular.dds",
+    };
+    DbHandle textures[2];
+    gfx_asset_acquire_textures(texturePaths, 2, textures, engine_job_parallel_for);
+
     build_primary_camera_entity();
-    build_lit_entities();
-    build_font_entities();
+    build_lit_entities(textures[0]);
+    build_font_entities(textures[1]);
 }
 
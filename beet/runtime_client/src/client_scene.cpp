@@ -0,0 +1,207 @@
+#include <client/client_scene.h>
+
+#include <core/engine_jobs.h>
+
+#include <gfx/gfx_lit.h>
+#include <gfx/gfx_font.h>
+#include <gfx/gfx_mesh.h>
+#include <gfx/gfx_asset_cache.h>
+#include <gfx/gfx_resource_db.h>
+
+#include <shared/scene_format.h>
+#include <shared/mapped_file.h>
+#include <shared/mem_tracker.h>
+#include <shared/profiler.h>
+#include <shared/ecs.h>
+#include <shared/log.h>
+#include <shared/assert.h>
+
+//===internal structs========
+// stride each section must have, same order as SceneSection.
+static const uint32_t s_sectionStrides[(uint32_t) SceneSection::Count] = {
+        sizeof(Transform),
+        sizeof(uint32_t),
+        sizeof(UiTransform),
+        sizeof(Camera),
+        sizeof(SceneMesh),
+        sizeof(SceneTexture),
+        sizeof(SceneLitMaterial),
+        sizeof(SceneFontMaterial),
+        sizeof(char),
+        sizeof(SceneComponentRef),
+        sizeof(SceneComponentRef),
+        sizeof(SceneComponentRef),
+        sizeof(SceneComponentRef),
+        sizeof(SceneComponentRef),
+        sizeof(SceneComponentRef),
+};
+
+//===internal functions======
+static const SceneHeader *validate_scene(const MappedFile &file, const char *path) {
+    const SceneHeader *header = (const SceneHeader *) file.data;
+    if (file.size < sizeof(SceneHeader) || header->magic != SCENE_MAGIC) {
+        log_warning(MSG_CLIENT, "scene %s isn't a scene file\n", path);
+        return nullptr;
+    }
+    if (header->version != SCENE_VERSION || header->sectionCount != (uint32_t) SceneSection::Count || header->fileSize != file.size) {
+        log_warning(MSG_CLIENT, "scene %s is version %u, expected %u\n", path, header->version, SCENE_VERSION);
+        return nullptr;
+    }
+    for (uint32_t i = 0; i < (uint32_t) SceneSection::Count; ++i) {
+        const SceneSectionInfo &info = header->sections[i];
+        if (info.stride != s_sectionStrides[i] || info.offset % SCENE_SECTION_ALIGNMENT != 0 || info.offset + (uint64_t) info.count * info.stride > file.size) {
+            log_warning(MSG_CLIENT, "scene %s section %u is malformed\n", path, i);
+            return nullptr;
+        }
+    }
+    return header;
+}
+
+// resolves a component section's resource indices to handles & adds them to the loaded entities in one batch.
+template<typename T>
+static void add_components(const SceneHeader &header, const SceneSection section, const Entity *entities, const DbHandle *resources,
+                           Entity *scratchEntities, T *scratchComponents) {
+    const SceneComponentRef *refs = scene_section<SceneComponentRef>(header, section);
+    const uint32_t count = scene_section_info(header, section).count;
+    for (uint32_t i = 0; i < count; ++i) {
+        scratchEntities[i] = entities[refs[i].entity];
+        scratchComponents[i] = T{resources[refs[i].resource]};
+    }
+    ecs_add_range(scratchEntities, scratchComponents, count);
+}
+
+static void validate_refs(const SceneHeader &header, const SceneSection section, const SceneSection resourceSection) {
+    const SceneComponentRef *refs = scene_section<SceneComponentRef>(header, section);
+    const uint32_t resourceCount = scene_section_info(header, resourceSection).count;
+    for (uint32_t i = 0; i < scene_section_info(header, section).count; ++i) {
+        ASSERT_MSG(refs[i].entity < header.entityCount && refs[i].resource < resourceCount,
+                   "Err: scene component [%u:%u] of section %u out of range", refs[i].entity, refs[i].resource, (uint32_t) section);
+    }
+}
+
+//===api=====================
+bool client_load_scene(const char *path) {
+    BEET_PROFILE_SCOPE("client_load_scene");
+    MappedFile file{};
+    if (!mapped_file_open(path, &file)) {
+        log_info(MSG_CLIENT, "no scene at %s\n", path);
+        return false;
+    }
+    const SceneHeader *validated = validate_scene(file, path);
+    if (validated == nullptr) {
+        mapped_file_close(&file);
+        return false;
+    }
+    const SceneHeader &header = *validated;
+    const uint32_t transformCount = scene_section_info(header, SceneSection::Transforms).count;
+    const uint32_t uiTransformCount = scene_section_info(header, SceneSection::UiTransforms).count;
+    const uint32_t cameraCount = scene_section_info(header, SceneSection::Cameras).count;
+    const uint32_t meshCount = scene_section_info(header, SceneSection::Meshes).count;
+    const uint32_t textureCount = scene_section_info(header, SceneSection::Textures).count;
+    const uint32_t litMaterialCount = scene_section_info(header, SceneSection::LitMaterials).count;
+    const uint32_t fontMaterialCount = scene_section_info(header, SceneSection::FontMaterials).count;
+    ASSERT_MSG(scene_section_info(header, SceneSection::TransformParents).count == transformCount, "Err: scene %s needs one parent per transform", path);
+    validate_refs(header, SceneSection::TransformComponents, SceneSection::Transforms);
+    validate_refs(header, SceneSection::UiTransformComponents, SceneSection::UiTransforms);
+    validate_refs(header, SceneSection::CameraComponents, SceneSection::Cameras);
+    validate_refs(header, SceneSection::MeshComponents, SceneSection::Meshes);
+    validate_refs(header, SceneSection::LitMaterialComponents, SceneSection::LitMaterials);
+    validate_refs(header, SceneSection::FontMaterialComponents, SceneSection::FontMaterials);
+
+    // one allocation for every index -> handle table, plus scratch for the largest component batch.
+    uint32_t maxComponents = 0;
+    for (uint32_t i = (uint32_t) SceneSection::TransformComponents; i < (uint32_t) SceneSection::Count; ++i) {
+        maxComponents = header.sections[i].count > maxComponents ? header.sections[i].count : maxComponents;
+    }
+    const uint32_t handleCount = transformCount + uiTransformCount + cameraCount + meshCount + textureCount + litMaterialCount + fontMaterialCount;
+    const size_t scratchBytes = sizeof(DbHandle) * handleCount
+                                + sizeof(Entity) * header.entityCount
+                                + (sizeof(Entity) + sizeof(DbHandle)) * maxComponents
+                                + sizeof(const char *) * textureCount;
+    unsigned char *scratch = (unsigned char *) mem_malloc(MSG_CLIENT, scratchBytes);
+    DbHandle *transforms = (DbHandle *) scratch;
+    DbHandle *uiTransforms = transforms + transformCount;
+    DbHandle *cameras = uiTransforms + uiTransformCount;
+    DbHandle *meshes = cameras + cameraCount;
+    DbHandle *textures = meshes + meshCount;
+    DbHandle *litMaterials = textures + textureCount;
+    DbHandle *fontMaterials = litMaterials + litMaterialCount;
+    DbHandle *scratchComponents = fontMaterials + fontMaterialCount;
+    Entity *entities = (Entity *) (scratchComponents + maxComponents);
+    Entity *scratchEntities = entities + header.entityCount;
+    const char **texturePaths = (const char **) (scratchEntities + maxComponents);
+
+    // bulk sections are copied straight out of the mapping.
+    gfx_db_add_transforms(scene_section<Transform>(header, SceneSection::Transforms),
+                          scene_section<uint32_t>(header, SceneSection::TransformParents), transformCount, transforms);
+    gfx_db_add_ui_transforms(scene_section<UiTransform>(header, SceneSection::UiTransforms), uiTransformCount, uiTransforms);
+
+    const Camera *sceneCameras = scene_section<Camera>(header, SceneSection::Cameras);
+    for (uint32_t i = 0; i < cameraCount; ++i) {
+        cameras[i] = gfx_db_add_camera(sceneCameras[i]);
+    }
+
+    const SceneMesh *sceneMeshes = scene_section<SceneMesh>(header, SceneSection::Meshes);
+    for (uint32_t i = 0; i < meshCount; ++i) {
+        GfxMesh mesh{};
+        switch (sceneMeshes[i].source) {
+            case SceneMeshSource::Cube:
+                gfx_create_mesh_async(gfx_cube_raw_mesh(), mesh);
+                break;
+            case SceneMeshSource::Plane:
+                gfx_create_mesh_async(gfx_plane_raw_mesh(), mesh);
+                break;
+            default: SANITY_CHECK();
+        }
+        meshes[i] = gfx_db_add_mesh(mesh);
+    }
+
+    const SceneTexture *sceneTextures = scene_section<SceneTexture>(header, SceneSection::Textures);
+    const char *strings = scene_section<char>(header, SceneSection::Strings);
+    const uint32_t stringsSize = scene_section_info(header, SceneSection::Strings).count;
+    for (uint32_t i = 0; i < textureCount; ++i) {
+        const SceneTexture &texture = sceneTextures[i];
+        ASSERT_MSG((uint64_t) texture.pathOffset + texture.pathLength < stringsSize && strings[texture.pathOffset + texture.pathLength] == '\0',
+                   "Err: scene %s texture %u path is out of range", path, i);
+        texturePaths[i] = strings + texture.pathOffset;
+    }
+    gfx_asset_acquire_textures(texturePaths, textureCount, textures, engine_job_parallel_for);
+
+    const SceneLitMaterial *sceneLitMaterials = scene_section<SceneLitMaterial>(header, SceneSection::LitMaterials);
+    for (uint32_t i = 0; i < litMaterialCount; ++i) {
+        ASSERT_MSG(sceneLitMaterials[i].albedoTexture < textureCount, "Err: scene %s lit material %u texture is out of range", path, i);
+        VkDescriptorSet descriptorSet;
+        gfx_lit_update_material_descriptor(descriptorSet, *gfx_db_get_texture(textures[sceneLitMaterials[i].albedoTexture]));
+
+        LitMaterial material{};
+        material.descriptorSetHandle = gfx_db_add_descriptor_set(descriptorSet);
+        material.albedoHandle = textures[sceneLitMaterials[i].albedoTexture];
+        litMaterials[i] = gfx_db_add_lit_material(material);
+    }
+
+    const SceneFontMaterial *sceneFontMaterials = scene_section<SceneFontMaterial>(header, SceneSection::FontMaterials);
+    for (uint32_t i = 0; i < fontMaterialCount; ++i) {
+        ASSERT_MSG(sceneFontMaterials[i].atlasTexture < textureCount, "Err: scene %s font material %u texture is out of range", path, i);
+        VkDescriptorSet descriptorSet;
+        gfx_font_update_material_descriptor(descriptorSet, *gfx_db_get_texture(textures[sceneFontMaterials[i].atlasTexture]));
+
+        FontMaterial material{};
+        material.descriptorSetHandle = gfx_db_add_descriptor_set(descriptorSet);
+        material.atlasHandle = textures[sceneFontMaterials[i].atlasTexture];
+        fontMaterials[i] = gfx_db_add_font_material(material);
+    }
+
+    ecs_create_entities(header.entityCount, entities);
+    // every component type holds just a handle, so they share the same scratch array.
+    add_components(header, SceneSection::TransformComponents, entities, transforms, scratchEntities, (TransformComponent *) scratchComponents);
+    add_components(header, SceneSection::UiTransformComponents, entities, uiTransforms, scratchEntities, (UiTransformComponent *) scratchComponents);
+    add_components(header, SceneSection::CameraComponents, entities, cameras, scratchEntities, (CameraComponent *) scratchComponents);
+    add_components(header, SceneSection::MeshComponents, entities, meshes, scratchEntities, (MeshComponent *) scratchComponents);
+    add_components(header, SceneSection::LitMaterialComponents, entities, litMaterials, scratchEntities, (LitMaterialComponent *) scratchComponents);
+    add_components(header, SceneSection::FontMaterialComponents, entities, fontMaterials, scratchEntities, (FontMaterialComponent *) scratchComponents);
+
+    log_info(MSG_CLIENT, "scene: %s entities: %u bytes: %llu\n", path, header.entityCount, (unsigned long long) file.size);
+    mem_free(scratch);
+    mapped_file_close(&file);
+    return true;
+}
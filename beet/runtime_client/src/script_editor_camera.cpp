@@ -2,15 +2,19 @@
 
 #include <gfx/gfx_resource_db.h>
 
+#include <shared/ecs.h>
+
 #include <core/input.h>
 #include <core/window.h>
 #include <core/time.h>
+#include <core/engine.h>
 
 #include <math/quat.h>
 
 void script_update_editor_camera() {
-    const CameraEntity *camEntity = gfx_db_get_camera_entity(0);
-    Transform *transform = gfx_db_get_transform(camEntity->transformIndex);
+    engine_validate_system_access(SYSTEM_ACCESS_TIME | SYSTEM_ACCESS_INPUT | SYSTEM_ACCESS_ENTITY, SYSTEM_ACCESS_WINDOW | SYSTEM_ACCESS_TRANSFORM);
+    const DbHandle transformHandle = ecs_get<TransformComponent>(ecs_first<CameraComponent>())->transformHandle;
+    Transform transform = gfx_db_get_transform(transformHandle);
 
     if (input_mouse_pressed(MouseButton::Right)) {
         window_set_cursor(CursorState::HiddenLockedLockMousePos);
@@ -24,12 +28,12 @@ void script_update_editor_camera() {
     if (input_mouse_down(MouseButton::Right)) {
         const vec2f delta = input_mouse_delta();
         const float mouseSpeed = 12.0f;
-        transform->rotation.y += (-delta.x * (float) time_delta()) * mouseSpeed;
-        transform->rotation.x += (-delta.y * (float) time_delta()) * mouseSpeed;
+        transform.rotation.y += (-delta.x * (float) time_delta()) * mouseSpeed;
+        transform.rotation.x += (-delta.y * (float) time_delta()) * mouseSpeed;
 
         vec3f moveDirection{};
-        const vec3f camForward = quat(transform->rotation) * WORLD_FORWARD;
-        const vec3f camRight = quat(transform->rotation) * WORLD_RIGHT;
+        const vec3f camForward = quat(transform.rotation) * WORLD_FORWARD;
+        const vec3f camRight = quat(transform.rotation) * WORLD_RIGHT;
 
         float moveSpeed = 5.0f;
         const float speedUpScalar = 4.0f;
@@ -58,6 +62,7 @@ void script_update_editor_camera() {
         if (input_key_down(KeyCode::Control)) {
             moveSpeed *= speedDownScalar;
         }
-        transform->position += moveDirection * ((float) time_delta() * moveSpeed);
+        transform.position += moveDirection * ((float) time_delta() * moveSpeed);
+        gfx_db_set_transform(transformHandle, transform);
     }
 }
\ No newline at end of file
@@ -1,3 +1,4 @@
+#include <core/engine.h>
 #include <core/window.h>
 #include <core/time.h>
 #include <cstdio>
@@ -85,26 +86,59 @@ void input_example() {
     }
 }
 
-int main() {
-    window_create();
-    time_create();
-    input_create();
-    socket_example_create_server();
+void server_setup_headless_system_orders() {
+    engine_register_system_create(0, "time_create", time_create);
+    engine_register_system_create(1, "socket_example_create_server", socket_example_create_server);
 
-    while (window_is_open()) {
-        time_tick();
-        input_set_time(time_current());
+    engine_register_system_update(0, SystemDesc{"time_tick", time_tick, SYSTEM_ACCESS_NONE, SYSTEM_ACCESS_TIME, false});
 
-        window_update();
-        input_update();
+    engine_register_system_fixed_update(0, SystemDesc{"socket_example_update_server", socket_example_update_server, SYSTEM_ACCESS_NONE, SYSTEM_ACCESS_NET, false});
 
-        input_example();
-        socket_example_update_server();
+    //executed as reverse iter
+    engine_register_system_cleanup(0, "time_cleanup", time_cleanup);
+    engine_register_system_cleanup(1, "socket_example_cleanup_server", socket_example_cleanup_server);
+}
+
+void server_setup_system_orders() {
+    engine_register_system_create(0, "window_create", window_create);
+    engine_register_system_create(1, "time_create", time_create);
+    engine_register_system_create(2, "input_create", input_create);
+    engine_register_system_create(3, "socket_example_create_server", socket_example_create_server);
+
+    engine_register_system_update(0, SystemDesc{"time_tick", time_tick, SYSTEM_ACCESS_NONE, SYSTEM_ACCESS_TIME, false});
+    engine_register_system_update(1, SystemDesc{"input_set_time", []() { input_set_time(time_current()); }, SYSTEM_ACCESS_TIME, SYSTEM_ACCESS_INPUT, false});
+    engine_register_system_update(2, SystemDesc{"window_update", window_update, SYSTEM_ACCESS_NONE, SYSTEM_ACCESS_WINDOW | SYSTEM_ACCESS_INPUT, true});
+    engine_register_system_update(3, SystemDesc{"input_update", input_update, SYSTEM_ACCESS_NONE, SYSTEM_ACCESS_INPUT, false});
+    engine_register_system_update(4, SystemDesc{"input_example", input_example, SYSTEM_ACCESS_TIME | SYSTEM_ACCESS_INPUT, SYSTEM_ACCESS_WINDOW, true});
+
+    // the network tick runs at up to 30Hz regardless of how fast the window loop spins.
+    engine_register_system_fixed_update(0, SystemDesc{"socket_example_update_server", socket_example_update_server, SYSTEM_ACCESS_NONE, SYSTEM_ACCESS_NET, false});
+
+    //executed as reverse iter
+    engine_register_system_cleanup(0, "window_cleanup", window_cleanup);
+    engine_register_system_cleanup(1, "time_cleanup", time_cleanup);
+    engine_register_system_cleanup(2, "input_cleanup", input_cleanup);
+    engine_register_system_cleanup(3, "socket_example_cleanup_server", socket_example_cleanup_server);
+}
+
+int main(int argc, char **argv) {
+    engine_create();
+    engine_apply_commandline(argc, argv);
+    // the socket receive blocks, so time spent waiting fills the accumulator. a single step per frame stops
+    // one slow receive from being followed by a burst of back to back catch up receives.
+    engine_set_fixed_timestep(1.0 / 30.0, 1);
+    if (engine_is_headless()) {
+        server_setup_headless_system_orders();
+    } else {
+        server_setup_system_orders();
+    }
+    engine_system_create();
+
+    while (engine_is_open()) {
+        engine_system_update();
     }
 
-    socket_example_cleanup_server();
-    input_cleanup();
-    time_cleanup();
-    window_cleanup();
+    engine_system_cleanup();
+    engine_cleanup();
     return 0;
 }
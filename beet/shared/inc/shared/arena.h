@@ -0,0 +1,41 @@
+#ifndef BEETROOT_ARENA_H
+#define BEETROOT_ARENA_H
+
+#include <shared/log.h>
+
+#include <cstddef>
+#include <cstdint>
+
+//===public structs==========
+struct ArenaBlock {
+    ArenaBlock *next;
+    size_t size;
+    size_t used;
+};
+
+// linear allocator, individual allocations are never freed, the whole arena is released at once.
+// allocations never move, pointers into an arena stay valid until arena_cleanup.
+struct Arena {
+    ArenaBlock *head;
+    size_t minBlockSize;
+    MSG_CHANNEL tag;
+};
+
+//===api=====================
+void *arena_alloc(Arena &arena, size_t size, size_t alignment);
+
+template<typename T>
+T *arena_alloc_array(Arena &arena, size_t count) {
+    return (T *) arena_alloc(arena, sizeof(T) * count, alignof(T));
+}
+
+// bytes handed out across every block, excluding alignment padding.
+size_t arena_used_bytes(const Arena &arena);
+uint32_t arena_block_count(const Arena &arena);
+
+//===init & shutdown=========
+// the first block is exactly initialSize, blocks added on overflow are at least minBlockSize.
+void arena_create(Arena &arena, size_t initialSize, size_t minBlockSize, MSG_CHANNEL tag);
+void arena_cleanup(Arena &arena);
+
+#endif //BEETROOT_ARENA_H
@@ -5,4 +5,8 @@
 
 uint32_t count_set_bits(uint32_t n);
 
+// index of the lowest / highest set bit, n must not be 0.
+uint32_t lowest_set_bit(uint64_t n);
+uint32_t highest_set_bit(uint64_t n);
+
 #endif //BEETROOT_BIT_UTILS_H
@@ -6,36 +6,38 @@
 #include <math/vec2.h>
 #include <cstdint>
 
-#define MAX_DB_CAMERA_ENTITIES 1
-#define MAX_DB_LIT_ENTITIES 64
-#define MAX_DB_FONT_ENTITIES 64
+// generation 0 is never handed out, a zero initialised handle is always invalid.
+#define DB_INVALID_GENERATION 0
 
-#define MAX_DB_CAMERAS 1
-#define MAX_DB_TRANSFORMS 64
-#define MAX_DB_UI_TRANSFORMS 64
-#define MAX_DB_GFX_TEXTURES 64
-#define MAX_DB_GFX_MESHES 64
+struct DbHandle {
+    uint32_t index{0};
+    uint32_t generation{DB_INVALID_GENERATION};
+};
 
-#define MAX_DB_VK_DESCRIPTOR_SETS 64
+// ecs components, each refers to a resource owned by the gfx db.
+// lit entities have transform, mesh & lit material, font entities ui transform, mesh & font material, cameras transform & camera.
+struct TransformComponent {
+    DbHandle transformHandle;
+};
 
-#define MAX_DB_LIT_MATERIALS 64
-#define MAX_DB_FONT_MATERIALS 16
+struct UiTransformComponent {
+    DbHandle uiTransformHandle;
+};
+
+struct MeshComponent {
+    DbHandle meshHandle;
+};
 
-struct LitEntity {
-    uint32_t transformIndex;
-    uint32_t meshIndex;
-    uint32_t materialIndex;
+struct LitMaterialComponent {
+    DbHandle materialHandle;
 };
 
-struct FontEntity {
-    uint32_t uiTransformIndex;
-    uint32_t meshIndex;
-    uint32_t materialIndex;
+struct FontMaterialComponent {
+    DbHandle materialHandle;
 };
 
-struct CameraEntity {
-    uint32_t transformIndex;
-    uint32_t cameraIndex;
+struct CameraComponent {
+    DbHandle cameraHandle;
 };
 
 struct Transform {
@@ -60,18 +62,18 @@ struct Camera {
 };
 
 struct FontMaterial {
-    uint32_t descriptorSetIndex{0};
-    uint32_t atlasIndex{0};
+    DbHandle descriptorSetHandle;
+    DbHandle atlasHandle;
 };
 
 struct LitMaterial {
-    uint32_t descriptorSetIndex{0};
-    uint32_t albedoIndex{0};
+    DbHandle descriptorSetHandle;
+    DbHandle albedoHandle;
     //TODO:GFX
-    //uint32_t normalIndex{0};
-    //uint32_t metallicIndex{0};
-    //uint32_t roughnessIndex{0};
-    //uint32_t occlusionIndex{0};
+    //DbHandle normalHandle;
+    //DbHandle metallicHandle;
+    //DbHandle roughnessHandle;
+    //DbHandle occlusionHandle;
     //
     //vec4f albedoColor{1.0f, 1.0f, 1.0f, 1.0f};
     //vec2f textureTiling{1.0f, 1.0f};
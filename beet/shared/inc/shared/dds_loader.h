@@ -2,6 +2,7 @@
 #define BEETROOT_DDS_LOADER_H
 
 #include <cstdint>
+#include <cstddef>
 #include <shared/texture_formats.h>
 //INFO: .dds file format spec
 // https://learn.microsoft.com/en-us/windows/win32/direct3ddds/dds-header
@@ -9,6 +10,18 @@
 // https://learn.microsoft.com/en-us/windows/win32/api/dxgiformat/ne-dxgiformat-dxgi_format
 // https://learn.microsoft.com/en-us/windows/uwp/gaming/complete-code-for-ddstextureloader
 
+// two phase load, query reads only the headers & fills everything but data & mipData.
+// the caller sizes its destination from dataSize & read_dds_payload reads the mip chain straight into it.
+// mips land largest first without padding, offsets follow from mipDataSizes.
+void query_dds_image(const char *path, RawImage* outRawImage);
+void read_dds_payload(const char *path, const RawImage* rawImage, void* dst, size_t dstSize);
+
+// reads the mip chain into a buffer allocated under MSG_DDS.
 void load_dds_image(const char *path, RawImage* outRawImage);
+// maps the file, data & mipData point straight into the mapping & the image is read only.
+// pages are only read from disk once they're touched, e.g. by the copy into a staging buffer.
+void map_dds_image(const char *path, RawImage* outRawImage);
+// frees or unmaps an image from either of the above.
+void release_dds_image(RawImage* rawImage);
 
 #endif //BEETROOT_DDS_LOADER_H
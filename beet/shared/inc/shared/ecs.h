@@ -0,0 +1,168 @@
+#ifndef BEETROOT_ECS_H
+#define BEETROOT_ECS_H
+
+#include <cstddef>
+#include <cstdint>
+
+//===defines=================
+// generation 0 is never handed out, a zero initialised entity is always invalid.
+#define ECS_INVALID_GENERATION 0
+#define ECS_MAX_COMPONENTS 64u
+
+// entity index -> dense index is paged, only pages holding an entity with the component are allocated.
+#define ECS_SPARSE_PAGE_SHIFT 12u
+#define ECS_SPARSE_PAGE_SIZE (1u << ECS_SPARSE_PAGE_SHIFT)
+#define ECS_SPARSE_PAGE_MASK (ECS_SPARSE_PAGE_SIZE - 1u)
+#define ECS_NOT_PRESENT UINT32_MAX
+
+//===public structs==========
+struct Entity {
+    uint32_t index{0};
+    uint32_t generation{ECS_INVALID_GENERATION};
+};
+
+// one sparse set per component type, components are packed in dense order without gaps.
+// removing a component moves the last one into its place, dense order is not stable.
+struct EcsPool {
+    uint32_t **sparsePages;
+    uint32_t sparsePageCount;
+
+    Entity *denseEntities;
+    unsigned char *denseData;
+    uint32_t count;
+    uint32_t capacity;
+    uint32_t componentSize;
+};
+
+//===api=====================
+Entity ecs_create_entity();
+// reserves room for count entities up front, then creates them into outEntities.
+void ecs_create_entities(uint32_t count, Entity *outEntities);
+// removes every component the entity has, the entity index is reused with a new generation.
+void ecs_destroy_entity(Entity entity);
+bool ecs_is_alive(Entity entity);
+uint32_t ecs_entity_count();
+
+// components are copied with memcpy when the dense arrays grow or are compacted, so must be trivially copyable.
+uint32_t ecs_register_component(uint32_t size, uint32_t alignment);
+EcsPool *ecs_pool(uint32_t componentId);
+
+// adding a component the entity already has overwrites it.
+void *ecs_add_component(Entity entity, uint32_t componentId, const void *component);
+// adds components[i] to entities[i], components is a packed array of the component type.
+void ecs_add_components(uint32_t componentId, const Entity *entities, const void *components, uint32_t count);
+void *ecs_get_component(Entity entity, uint32_t componentId);
+void *ecs_try_get_component(Entity entity, uint32_t componentId);
+bool ecs_has_component(Entity entity, uint32_t componentId);
+void ecs_remove_component(Entity entity, uint32_t componentId);
+
+inline uint32_t ecs_pool_find(const EcsPool &pool, const uint32_t entityIndex) {
+    const uint32_t page = entityIndex >> ECS_SPARSE_PAGE_SHIFT;
+    if (page >= pool.sparsePageCount || pool.sparsePages[page] == nullptr) {
+        return ECS_NOT_PRESENT;
+    }
+    return pool.sparsePages[page][entityIndex & ECS_SPARSE_PAGE_MASK];
+}
+
+template<typename T>
+inline T *ecs_pool_component(const EcsPool &pool, const uint32_t denseIndex) {
+    return (T *) (pool.denseData + (size_t) denseIndex * sizeof(T));
+}
+
+// ids are handed out the first time a type is used, they are only stable for the lifetime of the process.
+template<typename T>
+uint32_t ecs_component_id() {
+    static const uint32_t id = ecs_register_component(sizeof(T), alignof(T));
+    return id;
+}
+
+template<typename T>
+T *ecs_add(Entity entity, const T &component) {
+    return (T *) ecs_add_component(entity, ecs_component_id<T>(), &component);
+}
+
+template<typename T>
+void ecs_add_range(const Entity *entities, const T *components, uint32_t count) {
+    ecs_add_components(ecs_component_id<T>(), entities, components, count);
+}
+
+template<typename T>
+T *ecs_get(Entity entity) {
+    return (T *) ecs_get_component(entity, ecs_component_id<T>());
+}
+
+template<typename T>
+T *ecs_try_get(Entity entity) {
+    return (T *) ecs_try_get_component(entity, ecs_component_id<T>());
+}
+
+template<typename T>
+bool ecs_has(Entity entity) {
+    return ecs_has_component(entity, ecs_component_id<T>());
+}
+
+template<typename T>
+void ecs_remove(Entity entity) {
+    ecs_remove_component(entity, ecs_component_id<T>());
+}
+
+template<typename T>
+uint32_t ecs_count() {
+    return ecs_pool(ecs_component_id<T>())->count;
+}
+
+// first entity in T's dense order, an invalid entity when nothing has a T.
+template<typename T>
+Entity ecs_first() {
+    const EcsPool *pool = ecs_pool(ecs_component_id<T>());
+    return pool->count > 0 ? pool->denseEntities[0] : Entity{};
+}
+
+// position of T in Ts..., picks a component's pool out of the array ecs_each builds.
+template<typename T, typename... Ts>
+struct EcsTypeIndex;
+
+template<typename T, typename... Ts>
+struct EcsTypeIndex<T, T, Ts...> {
+    static const uint32_t value = 0;
+};
+
+template<typename T, typename U, typename... Ts>
+struct EcsTypeIndex<T, U, Ts...> {
+    static const uint32_t value = 1 + EcsTypeIndex<T, Ts...>::value;
+};
+
+// calls fn(Entity, Ts &...) for every entity that has all of Ts, walking the smallest pool in dense order.
+// the viewed components must not be added or removed from inside fn.
+template<typename... Ts, typename Fn>
+void ecs_each(Fn fn) {
+    EcsPool *pools[] = {ecs_pool(ecs_component_id<Ts>())...};
+    const uint32_t poolCount = sizeof...(Ts);
+
+    EcsPool *driver = pools[0];
+    for (uint32_t p = 1; p < poolCount; ++p) {
+        if (pools[p]->count < driver->count) {
+            driver = pools[p];
+        }
+    }
+
+    for (uint32_t i = 0; i < driver->count; ++i) {
+        const Entity entity = driver->denseEntities[i];
+        uint32_t denseIndices[sizeof...(Ts)];
+        bool match = true;
+        for (uint32_t p = 0; p < poolCount && match; ++p) {
+            denseIndices[p] = pools[p] == driver ? i : ecs_pool_find(*pools[p], entity.index);
+            match = denseIndices[p] != ECS_NOT_PRESENT;
+        }
+        if (!match) {
+            continue;
+        }
+        fn(entity, *ecs_pool_component<Ts>(*pools[EcsTypeIndex<Ts, Ts...>::value], denseIndices[EcsTypeIndex<Ts, Ts...>::value])...);
+    }
+}
+
+//===init & shutdown=========
+void ecs_create();
+void ecs_cleanup();
+
+#endif //BEETROOT_ECS_H
@@ -24,6 +24,9 @@ enum MSG_CHANNEL : uint32_t {
     MSG_MATH = 1u << 5u,
     MSG_NET = 1u << 6u,
     MSG_DDS = 1u << 7u,
+    MSG_ENGINE = 1u << 8u,
+    MSG_BENCH = 1u << 9u,
+    MSG_ECS = 1u << 10u,
 
     MSG_DBG = 1u << 31u,
     MSG_ALL = UINT32_MAX,
@@ -0,0 +1,21 @@
+#ifndef BEETROOT_MAPPED_FILE_H
+#define BEETROOT_MAPPED_FILE_H
+
+#include <cstddef>
+
+//===public structs==========
+// read only view of a whole file, pages are faulted in by the os as they're touched.
+struct MappedFile {
+    const void *data;
+    size_t size;
+
+    void *fileHandle;
+    void *mappingHandle;
+};
+
+//===api=====================
+// returns false when the file can't be opened, an empty file maps to a null view of size 0.
+bool mapped_file_open(const char *path, MappedFile *outFile);
+void mapped_file_close(MappedFile *file);
+
+#endif //BEETROOT_MAPPED_FILE_H
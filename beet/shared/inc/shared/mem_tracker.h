@@ -0,0 +1,108 @@
+#ifndef BEETROOT_MEM_TRACKER_H
+#define BEETROOT_MEM_TRACKER_H
+
+#include <shared/log.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <new>
+#include <utility>
+
+//===public structs==========
+struct MemTagStats {
+    uint64_t liveBytes;
+    uint64_t peakBytes;
+    uint64_t liveAllocations;
+    uint64_t totalAllocations;
+
+    // allocations & bytes requested during the last completed frame.
+    uint64_t frameAllocations;
+    uint64_t frameBytes;
+};
+
+//===api=====================
+// allocations are tagged with the log channel of the owning subsystem, i.e. MSG_GFX, MSG_DDS, MSG_PIPELINE.
+// blocks are 16 byte aligned, over aligned types must not go through the tracker.
+void *mem_malloc(MSG_CHANNEL tag, size_t size);
+void *mem_calloc(MSG_CHANNEL tag, size_t size);
+void mem_free(void *ptr);
+
+template<typename T, typename... Args>
+T *mem_new(MSG_CHANNEL tag, Args &&... args) {
+    void *memory = mem_malloc(tag, sizeof(T));
+    return new(memory) T(std::forward<Args>(args)...);
+}
+
+template<typename T>
+void mem_delete(T *ptr) {
+    if (ptr == nullptr) {
+        return;
+    }
+    ptr->~T();
+    mem_free(ptr);
+}
+
+// value initialised like new T[count]()
+template<typename T>
+T *mem_new_array(MSG_CHANNEL tag, size_t count) {
+    T *array = (T *) mem_malloc(tag, sizeof(T) * count);
+    for (size_t i = 0; i < count; ++i) {
+        new(&array[i]) T();
+    }
+    return array;
+}
+
+template<typename T>
+void mem_delete_array(T *ptr, size_t count) {
+    if (ptr == nullptr) {
+        return;
+    }
+    for (size_t i = 0; i < count; ++i) {
+        ptr[i].~T();
+    }
+    mem_free(ptr);
+}
+
+// routes std container storage through the tracker, i.e. std::vector<T, MemAllocator<T, MSG_GFX>>.
+template<typename T, MSG_CHANNEL Tag>
+struct MemAllocator {
+    typedef T value_type;
+
+    // the tag is a template argument, so containers can't rebind through the default allocator_traits.
+    template<typename U>
+    struct rebind {
+        typedef MemAllocator<U, Tag> other;
+    };
+
+    MemAllocator() = default;
+
+    template<typename U>
+    MemAllocator(const MemAllocator<U, Tag> &) {}
+
+    T *allocate(size_t count) {
+        return (T *) mem_malloc(Tag, sizeof(T) * count);
+    }
+
+    void deallocate(T *ptr, size_t) {
+        mem_free(ptr);
+    }
+};
+
+template<typename T, typename U, MSG_CHANNEL Tag>
+bool operator==(const MemAllocator<T, Tag> &, const MemAllocator<U, Tag> &) {
+    return true;
+}
+
+template<typename T, typename U, MSG_CHANNEL Tag>
+bool operator!=(const MemAllocator<T, Tag> &, const MemAllocator<U, Tag> &) {
+    return false;
+}
+
+MemTagStats mem_tracker_stats(MSG_CHANNEL tag);
+MemTagStats mem_tracker_total_stats();
+
+// rolls the per frame counters over, called once per frame by the engine.
+void mem_tracker_next_frame();
+void mem_tracker_log();
+
+#endif //BEETROOT_MEM_TRACKER_H
@@ -0,0 +1,43 @@
+#ifndef BEETROOT_PROFILER_H
+#define BEETROOT_PROFILER_H
+
+#include <cstdint>
+
+//===defines=================
+#define BEET_PROFILE_CONCAT_INTERNAL(a, b) a##b
+#define BEET_PROFILE_CONCAT(a, b) BEET_PROFILE_CONCAT_INTERNAL(a, b)
+
+#if BEET_PROFILE
+// name must outlive the profiler, string literals only.
+#define BEET_PROFILE_SCOPE(name) ProfileScope BEET_PROFILE_CONCAT(profileScope_, __LINE__)(name)
+#define BEET_PROFILE_FRAME_MARK() profiler_frame_mark()
+#define BEET_PROFILE_THREAD_NAME(name) profiler_set_thread_name(name)
+#else
+#define BEET_PROFILE_SCOPE(name)
+#define BEET_PROFILE_FRAME_MARK()
+#define BEET_PROFILE_THREAD_NAME(name)
+#endif
+
+//===public structs==========
+struct ProfileScope {
+    explicit ProfileScope(const char *name);
+    ~ProfileScope();
+
+    const char *name;
+    uint64_t startNs;
+};
+
+//===api=====================
+void profiler_frame_mark();
+uint32_t profiler_frame_index();
+void profiler_set_thread_name(const char *name);
+
+// writes every scope that overlaps [firstFrame, lastFrame] as chrome://tracing / ui.perfetto.dev json.
+// frames are clamped to the ones still held in the buffers, runs without frame marks export everything.
+bool profiler_export_chrome_trace(const char *path, uint32_t firstFrame, uint32_t lastFrame);
+
+//===init & shutdown=========
+void profiler_create();
+void profiler_cleanup();
+
+#endif //BEETROOT_PROFILER_H
@@ -0,0 +1,102 @@
+#ifndef BEETROOT_SCENE_FORMAT_H
+#define BEETROOT_SCENE_FORMAT_H
+
+#include <shared/db_types.h>
+
+#include <cstddef>
+#include <cstdint>
+
+// flat binary scene, written by the pipeline (pipeline/scene_writer.h) & mapped by the client (client/client_scene.h).
+// a header followed by fixed stride sections, resources refer to each other & entities by index into their section.
+// the only fixups on load are turning those indices into db handles & entities.
+
+//===defines=================
+#define SCENE_MAGIC 0x4E435342u // "BSCN"
+// bump whenever a section or any struct stored in one changes layout.
+#define SCENE_VERSION 1u
+#define SCENE_SECTION_ALIGNMENT 16u
+// no parent, no resource.
+#define SCENE_NONE UINT32_MAX
+
+//===public structs==========
+enum class SceneSection : uint32_t {
+    Transforms = 0,         // Transform
+    TransformParents,       // uint32_t index of an earlier transform or SCENE_NONE, one per transform
+    UiTransforms,           // UiTransform
+    Cameras,                // Camera
+    Meshes,                 // SceneMesh
+    Textures,               // SceneTexture
+    LitMaterials,           // SceneLitMaterial
+    FontMaterials,          // SceneFontMaterial
+    Strings,                // char, null terminated paths
+
+    TransformComponents,    // SceneComponentRef into Transforms
+    UiTransformComponents,  // SceneComponentRef into UiTransforms
+    CameraComponents,       // SceneComponentRef into Cameras
+    MeshComponents,         // SceneComponentRef into Meshes
+    LitMaterialComponents,  // SceneComponentRef into LitMaterials
+    FontMaterialComponents, // SceneComponentRef into FontMaterials
+
+    Count,
+};
+
+struct SceneSectionInfo {
+    // from the start of the file, aligned to SCENE_SECTION_ALIGNMENT.
+    uint64_t offset;
+    uint32_t count;
+    // sizeof the stored struct, checked on load so a layout change can't be read as garbage.
+    uint32_t stride;
+};
+
+struct SceneHeader {
+    uint32_t magic;
+    uint32_t version;
+    uint64_t fileSize;
+    uint32_t entityCount;
+    uint32_t sectionCount;
+    SceneSectionInfo sections[(uint32_t) SceneSection::Count];
+};
+
+// meshes the engine builds in code, there is no mesh asset format yet.
+enum class SceneMeshSource : uint32_t {
+    Cube = 0,
+    Plane = 1,
+};
+
+struct SceneMesh {
+    SceneMeshSource source;
+};
+
+struct SceneTexture {
+    // into the Strings section, the path is loaded through the asset cache.
+    uint32_t pathOffset;
+    uint32_t pathLength;
+};
+
+struct SceneLitMaterial {
+    uint32_t albedoTexture;
+};
+
+struct SceneFontMaterial {
+    uint32_t atlasTexture;
+};
+
+// component of entity `entity` refers to element `resource` of the section the component type points at.
+struct SceneComponentRef {
+    uint32_t entity;
+    uint32_t resource;
+};
+
+//===api=====================
+inline const SceneSectionInfo &scene_section_info(const SceneHeader &header, const SceneSection section) {
+    return header.sections[(uint32_t) section];
+}
+
+// the section as an array inside a validated file, nullptr when the section is empty.
+template<typename T>
+inline const T *scene_section(const SceneHeader &header, const SceneSection section) {
+    const SceneSectionInfo &info = scene_section_info(header, section);
+    return info.count > 0 ? (const T *) ((const unsigned char *) &header + info.offset) : nullptr;
+}
+
+#endif //BEETROOT_SCENE_FORMAT_H
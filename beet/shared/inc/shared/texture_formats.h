@@ -1,6 +1,8 @@
 #ifndef BEETROOT_TEXTURE_FORMATS_H
 #define BEETROOT_TEXTURE_FORMATS_H
 
+#include <shared/mapped_file.h>
+
 #include <cstdint>
 
 #define BEET_MAX_MIP_COUNT 16
@@ -29,7 +31,11 @@ struct RawImage {
 
     uint32_t dataSize;
     uint32_t mipDataSizes[BEET_MAX_MIP_COUNT];
+    // start of each mip inside data, mips are stored largest first without padding.
+    const void* mipData[BEET_MAX_MIP_COUNT];
     void* data;
+    // only set for mapped images, data then points into the mapping.
+    MappedFile mapping;
 };
 
 #endif //BEETROOT_TEXTURE_FORMATS_H
@@ -0,0 +1,73 @@
+#include <shared/arena.h>
+#include <shared/assert.h>
+#include <shared/mem_tracker.h>
+
+//===internal functions======
+static size_t align_up(const size_t value, const size_t alignment) {
+    return (value + alignment - 1) & ~(alignment - 1);
+}
+
+static ArenaBlock *arena_add_block(Arena &arena, const size_t size) {
+    // block data starts right after the header, the header size keeps it 16 byte aligned.
+    const size_t headerSize = align_up(sizeof(ArenaBlock), 16);
+    ArenaBlock *block = (ArenaBlock *) mem_malloc(arena.tag, headerSize + size);
+    block->next = arena.head;
+    block->size = size;
+    block->used = 0;
+    arena.head = block;
+    return block;
+}
+
+static unsigned char *block_data(ArenaBlock *block) {
+    return (unsigned char *) block + align_up(sizeof(ArenaBlock), 16);
+}
+
+//===api=====================
+void *arena_alloc(Arena &arena, size_t size, size_t alignment) {
+    ASSERT_MSG(alignment != 0 && (alignment & (alignment - 1)) == 0 && alignment <= 16, "Err: unsupported arena alignment %zu", alignment);
+
+    ArenaBlock *block = arena.head;
+    if (block == nullptr || align_up(block->used, alignment) + size > block->size) {
+        block = arena_add_block(arena, size > arena.minBlockSize ? size : arena.minBlockSize);
+    }
+
+    const size_t offset = align_up(block->used, alignment);
+    block->used = offset + size;
+    return block_data(block) + offset;
+}
+
+size_t arena_used_bytes(const Arena &arena) {
+    size_t used = 0;
+    for (const ArenaBlock *block = arena.head; block != nullptr; block = block->next) {
+        used += block->used;
+    }
+    return used;
+}
+
+uint32_t arena_block_count(const Arena &arena) {
+    uint32_t count = 0;
+    for (const ArenaBlock *block = arena.head; block != nullptr; block = block->next) {
+        count++;
+    }
+    return count;
+}
+
+//===init & shutdown=========
+void arena_create(Arena &arena, size_t initialSize, size_t minBlockSize, MSG_CHANNEL tag) {
+    arena.head = nullptr;
+    arena.minBlockSize = minBlockSize;
+    arena.tag = tag;
+    if (initialSize > 0) {
+        arena_add_block(arena, initialSize);
+    }
+}
+
+void arena_cleanup(Arena &arena) {
+    ArenaBlock *block = arena.head;
+    while (block != nullptr) {
+        ArenaBlock *next = block->next;
+        mem_free(block);
+        block = next;
+    }
+    arena.head = nullptr;
+}
@@ -1,5 +1,9 @@
 #include <shared/bit_utils.h>
 
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
 uint32_t count_set_bits(uint32_t n) {
     uint32_t count = 0;
     while (n) {
@@ -7,4 +11,24 @@ uint32_t count_set_bits(uint32_t n) {
         n >>= 1;
     }
     return count;
-}
\ No newline at end of file
+}
+
+uint32_t lowest_set_bit(uint64_t n) {
+#if defined(_MSC_VER)
+    unsigned long index;
+    _BitScanForward64(&index, n);
+    return (uint32_t) index;
+#else
+    return (uint32_t) __builtin_ctzll(n);
+#endif
+}
+
+uint32_t highest_set_bit(uint64_t n) {
+#if defined(_MSC_VER)
+    unsigned long index;
+    _BitScanReverse64(&index, n);
+    return (uint32_t) index;
+#else
+    return 63u - (uint32_t) __builtin_clzll(n);
+#endif
+}
@@ -2,9 +2,13 @@
 #include <shared/log.h>
 #include <shared/assert.h>
 #include <shared/texture_formats.h>
+#include <shared/profiler.h>
+#include <shared/mem_tracker.h>
+#include <shared/mapped_file.h>
 
 #include <iostream>
 #include <fstream>
+#include <cstring>
 
 struct PixelFormatDDS {
     uint32_t dwSize;                // dwSize:          Structure size
@@ -411,24 +415,18 @@ static void get_image_info(
     }
 }
 
-void load_dds_image(const char *path, RawImage *outRawImage) {
-    log_verbose(MSG_DDS, "loading dds image : %s \n", path);
-
-    std::ifstream file{path, std::ios::ate | std::ios::binary};
-    ASSERT_MSG(file.is_open(), "Err: failed to find path: %s \n", path);
-    const size_t fileSize = file.tellg();
+// dds magic, header & dxt10 header, the mip chain follows straight after.
+static const size_t DDS_PAYLOAD_OFFSET = sizeof(uint32_t) + sizeof(HeaderDDS) + sizeof(HeaderDDSDXT10);
 
-    char *rawFileData = (char *) malloc(fileSize);
-    char ext[4] = {};
-    file.seekg(0);
-    file.read(ext, sizeof(uint32_t));
-    file.read(rawFileData, fileSize - sizeof(uint32_t));
+// fills everything but data & mipData from the headers at the start of the file.
+static void parse_dds_headers(const char *path, const unsigned char *fileStart, const size_t fileSize, RawImage *outRawImage) {
+    ASSERT_MSG(fileSize >= DDS_PAYLOAD_OFFSET, "Err: %s is too small to be a dds file, size %zu \n", path, fileSize);
+    const char *ext = (const char *) fileStart;
     const char expectedHeaderFmt[4] = {'D', 'D', 'S', ' '};
     ASSERT_MSG(memcmp(ext, expectedHeaderFmt, sizeof(char) * 4) == 0,
                "Err: input header did not match [D][D][S][] received [%c][%c][%c][%c] for path : %s \n", ext[0], ext[1], ext[2], ext[3], path);
-    file.close();
 
-    const HeaderDDS *header = reinterpret_cast<const HeaderDDS *> (rawFileData);
+    const HeaderDDS *header = reinterpret_cast<const HeaderDDS *> (fileStart + sizeof(uint32_t));
 
     const uint32_t width = header->dwWidth;
     const uint32_t height = header->dwHeight;
@@ -455,18 +453,79 @@ void load_dds_image(const char *path, RawImage *outRawImage) {
             sumOfMipData += outNumBytes;
         }
     }
+    ASSERT_MSG(DDS_PAYLOAD_OFFSET + sumOfMipData <= fileSize, "Err: %s mip chain of %zu bytes runs past the end of the file \n", path, sumOfMipData);
 
-    const void *imageStartPos = (unsigned char *) header + sizeof(HeaderDDS) + sizeof(HeaderDDSDXT10);
     outRawImage->textureFormat = internal_dxgi_to_beet_texture_format(format);
     outRawImage->mipMapCount = mipCount;
     outRawImage->width = width;
     outRawImage->height = height;
     outRawImage->depth = depth;
     outRawImage->dataSize = sumOfMipData;
+}
 
-    outRawImage->data = (unsigned char *) malloc(outRawImage->dataSize);
-    memset(outRawImage->data, 0, outRawImage->dataSize);
-    memcpy(outRawImage->data, imageStartPos, outRawImage->dataSize);
+static void set_mip_data(RawImage *rawImage) {
+    size_t offset = 0;
+    for (uint32_t i = 0; i < rawImage->mipMapCount; ++i) {
+        rawImage->mipData[i] = (const unsigned char *) rawImage->data + offset;
+        offset += rawImage->mipDataSizes[i];
+    }
+}
+
+void query_dds_image(const char *path, RawImage *outRawImage) {
+    BEET_PROFILE_SCOPE("query_dds_image");
+    log_verbose(MSG_DDS, "querying dds image : %s \n", path);
+    *outRawImage = RawImage{};
+
+    std::ifstream file{path, std::ios::ate | std::ios::binary};
+    ASSERT_MSG(file.is_open(), "Err: failed to find path: %s \n", path);
+    const size_t fileSize = file.tellg();
 
-    free(rawFileData);
-}
\ No newline at end of file
+    unsigned char headers[DDS_PAYLOAD_OFFSET] = {};
+    file.seekg(0);
+    file.read((char *) headers, fileSize < DDS_PAYLOAD_OFFSET ? fileSize : DDS_PAYLOAD_OFFSET);
+    file.close();
+    parse_dds_headers(path, headers, fileSize, outRawImage);
+}
+
+void read_dds_payload(const char *path, const RawImage *rawImage, void *dst, size_t dstSize) {
+    BEET_PROFILE_SCOPE("read_dds_payload");
+    ASSERT_MSG(dstSize >= rawImage->dataSize, "Err: %s needs %u bytes, destination is %zu bytes \n", path, rawImage->dataSize, dstSize);
+
+    std::ifstream file{path, std::ios::binary};
+    ASSERT_MSG(file.is_open(), "Err: failed to find path: %s \n", path);
+    file.seekg(DDS_PAYLOAD_OFFSET);
+    file.read((char *) dst, rawImage->dataSize);
+    ASSERT_MSG((size_t) file.gcount() == rawImage->dataSize, "Err: %s ended after %zu of %u payload bytes \n", path, (size_t) file.gcount(), rawImage->dataSize);
+    file.close();
+}
+
+void load_dds_image(const char *path, RawImage *outRawImage) {
+    BEET_PROFILE_SCOPE("load_dds_image");
+    query_dds_image(path, outRawImage);
+    outRawImage->data = mem_malloc(MSG_DDS, outRawImage->dataSize);
+    read_dds_payload(path, outRawImage, outRawImage->data, outRawImage->dataSize);
+    set_mip_data(outRawImage);
+}
+
+void map_dds_image(const char *path, RawImage *outRawImage) {
+    BEET_PROFILE_SCOPE("map_dds_image");
+    log_verbose(MSG_DDS, "mapping dds image : %s \n", path);
+    *outRawImage = RawImage{};
+
+    const bool mapped = mapped_file_open(path, &outRawImage->mapping);
+    ASSERT_MSG(mapped, "Err: failed to find path: %s \n", path);
+    const unsigned char *fileStart = (const unsigned char *) outRawImage->mapping.data;
+    parse_dds_headers(path, fileStart, outRawImage->mapping.size, outRawImage);
+
+    outRawImage->data = (void *) (fileStart + DDS_PAYLOAD_OFFSET);
+    set_mip_data(outRawImage);
+}
+
+void release_dds_image(RawImage *rawImage) {
+    if (rawImage->mapping.data != nullptr) {
+        mapped_file_close(&rawImage->mapping);
+    } else if (rawImage->data != nullptr) {
+        mem_free(rawImage->data);
+    }
+    *rawImage = RawImage{};
+}
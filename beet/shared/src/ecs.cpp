@@ -0,0 +1,268 @@
+#include <shared/ecs.h>
+#include <shared/assert.h>
+#include <shared/log.h>
+#include <shared/mem_tracker.h>
+
+#include <cstring>
+
+//===defines=================
+// stored in EcsWorld::nextFree, any other value is the next entity index in the free list.
+#define ECS_ENTITY_ALIVE UINT32_MAX
+#define ECS_ENTITY_NONE (UINT32_MAX - 1u)
+
+#define ECS_MIN_CAPACITY 64u
+
+//===internal structs========
+struct EcsComponentInfo {
+    uint32_t size;
+    uint32_t alignment;
+};
+
+struct EcsWorld {
+    uint32_t *generations;
+    uint32_t *nextFree;
+    // entity indices handed out at least once.
+    uint32_t slotCount;
+    uint32_t capacity;
+    uint32_t freeHead;
+    uint32_t aliveCount;
+
+    EcsPool pools[ECS_MAX_COMPONENTS];
+};
+
+// component types are registered independent of the world, ids stay valid across ecs_create & ecs_cleanup.
+static EcsComponentInfo s_componentInfos[ECS_MAX_COMPONENTS] = {};
+static uint32_t s_componentCount = 0;
+
+EcsWorld *g_ecsWorld = nullptr;
+
+//===internal functions======
+static uint32_t grow_capacity(const uint32_t capacity, const uint32_t required) {
+    uint32_t newCapacity = capacity > ECS_MIN_CAPACITY ? capacity : ECS_MIN_CAPACITY;
+    while (newCapacity < required) {
+        newCapacity *= 2;
+    }
+    return newCapacity;
+}
+
+static void *realloc_tracked(void *ptr, const size_t oldSize, const size_t newSize) {
+    void *result = mem_malloc(MSG_ECS, newSize);
+    if (ptr != nullptr) {
+        memcpy(result, ptr, oldSize);
+        mem_free(ptr);
+    }
+    return result;
+}
+
+static void world_grow(EcsWorld &world, const uint32_t required) {
+    const uint32_t capacity = grow_capacity(world.capacity, required);
+    world.generations = (uint32_t *) realloc_tracked(world.generations, sizeof(uint32_t) * world.capacity, sizeof(uint32_t) * capacity);
+    world.nextFree = (uint32_t *) realloc_tracked(world.nextFree, sizeof(uint32_t) * world.capacity, sizeof(uint32_t) * capacity);
+    world.capacity = capacity;
+}
+
+static uint32_t *pool_sparse_slot(EcsPool &pool, const uint32_t entityIndex) {
+    const uint32_t page = entityIndex >> ECS_SPARSE_PAGE_SHIFT;
+    if (page >= pool.sparsePageCount) {
+        const uint32_t pageCount = page + 1 > pool.sparsePageCount * 2 ? page + 1 : pool.sparsePageCount * 2;
+        pool.sparsePages = (uint32_t **) realloc_tracked(pool.sparsePages, sizeof(uint32_t *) * pool.sparsePageCount, sizeof(uint32_t *) * pageCount);
+        memset(pool.sparsePages + pool.sparsePageCount, 0, sizeof(uint32_t *) * (pageCount - pool.sparsePageCount));
+        pool.sparsePageCount = pageCount;
+    }
+    if (pool.sparsePages[page] == nullptr) {
+        pool.sparsePages[page] = (uint32_t *) mem_malloc(MSG_ECS, sizeof(uint32_t) * ECS_SPARSE_PAGE_SIZE);
+        memset(pool.sparsePages[page], 0xFF, sizeof(uint32_t) * ECS_SPARSE_PAGE_SIZE);
+    }
+    return &pool.sparsePages[page][entityIndex & ECS_SPARSE_PAGE_MASK];
+}
+
+static void pool_grow(EcsPool &pool, const uint32_t required) {
+    const uint32_t capacity = grow_capacity(pool.capacity, required);
+    pool.denseEntities = (Entity *) realloc_tracked(pool.denseEntities, sizeof(Entity) * pool.count, sizeof(Entity) * capacity);
+    pool.denseData = (unsigned char *) realloc_tracked(pool.denseData, (size_t) pool.componentSize * pool.count, (size_t) pool.componentSize * capacity);
+    pool.capacity = capacity;
+}
+
+static void pool_remove(EcsPool &pool, const uint32_t entityIndex) {
+    uint32_t *sparse = pool_sparse_slot(pool, entityIndex);
+    const uint32_t dense = *sparse;
+    const uint32_t last = pool.count - 1;
+    if (dense != last) {
+        // keep the dense arrays packed by moving the last component into the gap.
+        memcpy(pool.denseData + (size_t) dense * pool.componentSize, pool.denseData + (size_t) last * pool.componentSize, pool.componentSize);
+        pool.denseEntities[dense] = pool.denseEntities[last];
+        *pool_sparse_slot(pool, pool.denseEntities[dense].index) = dense;
+    }
+    *sparse = ECS_NOT_PRESENT;
+    pool.count--;
+}
+
+static void pool_cleanup(EcsPool &pool) {
+    for (uint32_t i = 0; i < pool.sparsePageCount; ++i) {
+        if (pool.sparsePages[i] != nullptr) {
+            mem_free(pool.sparsePages[i]);
+        }
+    }
+    if (pool.sparsePages != nullptr) {
+        mem_free(pool.sparsePages);
+    }
+    if (pool.denseEntities != nullptr) {
+        mem_free(pool.denseEntities);
+        mem_free(pool.denseData);
+    }
+    pool = EcsPool{};
+}
+
+static void validate_component(const uint32_t componentId) {
+    ASSERT_MSG(componentId < s_componentCount, "Err: unregistered component id %u, registered [%u]", componentId, s_componentCount);
+}
+
+//===api=====================
+Entity ecs_create_entity() {
+    EcsWorld &world = *g_ecsWorld;
+    uint32_t index;
+    if (world.freeHead != ECS_ENTITY_NONE) {
+        index = world.freeHead;
+        world.freeHead = world.nextFree[index];
+    } else {
+        if (world.slotCount == world.capacity) {
+            world_grow(world, world.capacity + 1);
+        }
+        index = world.slotCount++;
+        world.generations[index] = ECS_INVALID_GENERATION + 1;
+    }
+    world.nextFree[index] = ECS_ENTITY_ALIVE;
+    world.aliveCount++;
+
+    Entity entity;
+    entity.index = index;
+    entity.generation = world.generations[index];
+    return entity;
+}
+
+void ecs_create_entities(uint32_t count, Entity *outEntities) {
+    EcsWorld &world = *g_ecsWorld;
+    if (world.slotCount + count > world.capacity) {
+        world_grow(world, world.slotCount + count);
+    }
+    for (uint32_t i = 0; i < count; ++i) {
+        outEntities[i] = ecs_create_entity();
+    }
+}
+
+void ecs_destroy_entity(Entity entity) {
+    EcsWorld &world = *g_ecsWorld;
+    ASSERT_MSG(ecs_is_alive(entity), "Err: destroying stale entity [%u:%u]", entity.index, entity.generation);
+    for (uint32_t i = 0; i < s_componentCount; ++i) {
+        EcsPool &pool = world.pools[i];
+        if (pool.count > 0 && ecs_pool_find(pool, entity.index) != ECS_NOT_PRESENT) {
+            pool_remove(pool, entity.index);
+        }
+    }
+    world.generations[entity.index]++;
+    if (world.generations[entity.index] == ECS_INVALID_GENERATION) {
+        world.generations[entity.index]++;
+    }
+    world.nextFree[entity.index] = world.freeHead;
+    world.freeHead = entity.index;
+    world.aliveCount--;
+}
+
+bool ecs_is_alive(Entity entity) {
+    const EcsWorld &world = *g_ecsWorld;
+    return entity.index < world.slotCount
+           && world.nextFree[entity.index] == ECS_ENTITY_ALIVE
+           && world.generations[entity.index] == entity.generation;
+}
+
+uint32_t ecs_entity_count() {
+    return g_ecsWorld->aliveCount;
+}
+
+uint32_t ecs_register_component(uint32_t size, uint32_t alignment) {
+    ASSERT_MSG(s_componentCount < ECS_MAX_COMPONENTS, "Err: too many component types, max [%u]", ECS_MAX_COMPONENTS);
+    ASSERT_MSG(alignment <= 16, "Err: unsupported component alignment %u", alignment);
+    s_componentInfos[s_componentCount] = EcsComponentInfo{size, alignment};
+    return s_componentCount++;
+}
+
+EcsPool *ecs_pool(uint32_t componentId) {
+    validate_component(componentId);
+    EcsPool &pool = g_ecsWorld->pools[componentId];
+    pool.componentSize = s_componentInfos[componentId].size;
+    return &pool;
+}
+
+void *ecs_add_component(Entity entity, uint32_t componentId, const void *component) {
+    ASSERT_MSG(ecs_is_alive(entity), "Err: adding component %u to stale entity [%u:%u]", componentId, entity.index, entity.generation);
+    EcsPool &pool = *ecs_pool(componentId);
+    uint32_t *sparse = pool_sparse_slot(pool, entity.index);
+    if (*sparse == ECS_NOT_PRESENT) {
+        if (pool.count == pool.capacity) {
+            pool_grow(pool, pool.count + 1);
+        }
+        *sparse = pool.count++;
+        pool.denseEntities[*sparse] = entity;
+    }
+    void *data = pool.denseData + (size_t) *sparse * pool.componentSize;
+    memcpy(data, component, pool.componentSize);
+    return data;
+}
+
+void ecs_add_components(uint32_t componentId, const Entity *entities, const void *components, uint32_t count) {
+    EcsPool &pool = *ecs_pool(componentId);
+    if (pool.count + count > pool.capacity) {
+        pool_grow(pool, pool.count + count);
+    }
+    for (uint32_t i = 0; i < count; ++i) {
+        ecs_add_component(entities[i], componentId, (const unsigned char *) components + (size_t) i * pool.componentSize);
+    }
+}
+
+void *ecs_get_component(Entity entity, uint32_t componentId) {
+    void *data = ecs_try_get_component(entity, componentId);
+    ASSERT_MSG(data != nullptr, "Err: entity [%u:%u] has no component %u", entity.index, entity.generation, componentId);
+    return data;
+}
+
+void *ecs_try_get_component(Entity entity, uint32_t componentId) {
+    ASSERT_MSG(ecs_is_alive(entity), "Err: stale entity [%u:%u]", entity.index, entity.generation);
+    const EcsPool &pool = *ecs_pool(componentId);
+    const uint32_t dense = ecs_pool_find(pool, entity.index);
+    if (dense == ECS_NOT_PRESENT) {
+        return nullptr;
+    }
+    return pool.denseData + (size_t) dense * pool.componentSize;
+}
+
+bool ecs_has_component(Entity entity, uint32_t componentId) {
+    return ecs_try_get_component(entity, componentId) != nullptr;
+}
+
+void ecs_remove_component(Entity entity, uint32_t componentId) {
+    ASSERT_MSG(ecs_has_component(entity, componentId), "Err: entity [%u:%u] has no component %u to remove", entity.index, entity.generation, componentId);
+    pool_remove(*ecs_pool(componentId), entity.index);
+}
+
+//===init & shutdown=========
+void ecs_create() {
+    ASSERT_MSG(g_ecsWorld == nullptr, "Err: ecs has already been created");
+    g_ecsWorld = mem_new<EcsWorld>(MSG_ECS);
+    *g_ecsWorld = EcsWorld{};
+    g_ecsWorld->freeHead = ECS_ENTITY_NONE;
+}
+
+void ecs_cleanup() {
+    if (g_ecsWorld == nullptr) {
+        return;
+    }
+    for (EcsPool &pool: g_ecsWorld->pools) {
+        pool_cleanup(pool);
+    }
+    if (g_ecsWorld->generations != nullptr) {
+        mem_free(g_ecsWorld->generations);
+        mem_free(g_ecsWorld->nextFree);
+    }
+    mem_delete(g_ecsWorld);
+    g_ecsWorld = nullptr;
+}
@@ -18,6 +18,12 @@ const char *log_channel_name_lookup(const MSG_CHANNEL &channel) {
             return "[net]";
         case MSG_DDS:
             return "[dds]";
+        case MSG_ENGINE:
+            return "[engine]";
+        case MSG_BENCH:
+            return "[bench]";
+        case MSG_ECS:
+            return "[ecs]";
         case MSG_DBG:
             return "[debugging]";
 
@@ -0,0 +1,91 @@
+#include <shared/mapped_file.h>
+
+#if defined(_WIN32)
+#define WIN32_LEAN_AND_MEAN
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+//===api=====================
+#if defined(_WIN32)
+bool mapped_file_open(const char *path, MappedFile *outFile) {
+    *outFile = MappedFile{};
+    HANDLE file = CreateFileA(path, GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+    if (file == INVALID_HANDLE_VALUE) {
+        return false;
+    }
+    LARGE_INTEGER size{};
+    if (!GetFileSizeEx(file, &size)) {
+        CloseHandle(file);
+        return false;
+    }
+    outFile->fileHandle = file;
+    outFile->size = (size_t) size.QuadPart;
+    if (outFile->size == 0) {
+        return true;
+    }
+
+    HANDLE mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    if (mapping == nullptr) {
+        mapped_file_close(outFile);
+        return false;
+    }
+    outFile->mappingHandle = mapping;
+    outFile->data = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+    if (outFile->data == nullptr) {
+        mapped_file_close(outFile);
+        return false;
+    }
+    return true;
+}
+
+void mapped_file_close(MappedFile *file) {
+    if (file->data != nullptr) {
+        UnmapViewOfFile(file->data);
+    }
+    if (file->mappingHandle != nullptr) {
+        CloseHandle((HANDLE) file->mappingHandle);
+    }
+    if (file->fileHandle != nullptr) {
+        CloseHandle((HANDLE) file->fileHandle);
+    }
+    *file = MappedFile{};
+}
+#else
+bool mapped_file_open(const char *path, MappedFile *outFile) {
+    *outFile = MappedFile{};
+    const int fd = open(path, O_RDONLY);
+    if (fd < 0) {
+        return false;
+    }
+    struct stat info{};
+    if (fstat(fd, &info) != 0) {
+        close(fd);
+        return false;
+    }
+    outFile->size = (size_t) info.st_size;
+    if (outFile->size > 0) {
+        void *data = mmap(nullptr, outFile->size, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (data == MAP_FAILED) {
+            close(fd);
+            *outFile = MappedFile{};
+            return false;
+        }
+        outFile->data = data;
+    }
+    // the mapping keeps the file alive, the descriptor isn't needed past this point.
+    close(fd);
+    return true;
+}
+
+void mapped_file_close(MappedFile *file) {
+    if (file->data != nullptr) {
+        munmap((void *) file->data, file->size);
+    }
+    *file = MappedFile{};
+}
+#endif
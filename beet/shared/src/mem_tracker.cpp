@@ -0,0 +1,149 @@
+#include <shared/mem_tracker.h>
+#include <shared/assert.h>
+
+#include <atomic>
+#include <cstdlib>
+#include <cstring>
+
+//===defines=================
+#define BEET_MEM_TAG_COUNT 32u
+#define BEET_MEM_HEADER_MAGIC 0xBEE7A110u
+
+//===internal structs========
+// stored in front of every tracked block, 16 bytes so the user pointer keeps malloc's alignment.
+struct MemHeader {
+    uint64_t size;
+    uint32_t tagIndex;
+    uint32_t magic;
+};
+
+struct MemTagCounters {
+    std::atomic<uint64_t> liveBytes;
+    std::atomic<uint64_t> peakBytes;
+    std::atomic<uint64_t> liveAllocations;
+    std::atomic<uint64_t> totalAllocations;
+    std::atomic<uint64_t> frameAllocations;
+    std::atomic<uint64_t> frameBytes;
+    uint64_t lastFrameAllocations;
+    uint64_t lastFrameBytes;
+};
+
+// static storage instead of a create / cleanup pair, allocations are tracked before any subsystem exists.
+static MemTagCounters s_memTags[BEET_MEM_TAG_COUNT];
+
+//===internal functions======
+static uint32_t tag_to_index(const MSG_CHANNEL tag) {
+    // untagged allocations land in slot 0, which no channel uses.
+    if (tag == MSG_NONE || tag == MSG_ALL) {
+        return 0;
+    }
+    uint32_t index = 0;
+    uint32_t bits = (uint32_t) tag;
+    while ((bits & 1u) == 0) {
+        bits >>= 1u;
+        index++;
+    }
+    return index;
+}
+
+static void update_peak(std::atomic<uint64_t> &peak, const uint64_t value) {
+    uint64_t current = peak.load(std::memory_order_relaxed);
+    while (value > current && !peak.compare_exchange_weak(current, value, std::memory_order_relaxed)) {}
+}
+
+static void track_alloc(const uint32_t tagIndex, const uint64_t size) {
+    MemTagCounters &counters = s_memTags[tagIndex];
+    const uint64_t live = counters.liveBytes.fetch_add(size, std::memory_order_relaxed) + size;
+    update_peak(counters.peakBytes, live);
+    counters.liveAllocations.fetch_add(1, std::memory_order_relaxed);
+    counters.totalAllocations.fetch_add(1, std::memory_order_relaxed);
+    counters.frameAllocations.fetch_add(1, std::memory_order_relaxed);
+    counters.frameBytes.fetch_add(size, std::memory_order_relaxed);
+}
+
+static void track_free(const uint32_t tagIndex, const uint64_t size) {
+    MemTagCounters &counters = s_memTags[tagIndex];
+    counters.liveBytes.fetch_sub(size, std::memory_order_relaxed);
+    counters.liveAllocations.fetch_sub(1, std::memory_order_relaxed);
+}
+
+static MemTagStats counters_to_stats(const MemTagCounters &counters) {
+    MemTagStats stats{};
+    stats.liveBytes = counters.liveBytes.load(std::memory_order_relaxed);
+    stats.peakBytes = counters.peakBytes.load(std::memory_order_relaxed);
+    stats.liveAllocations = counters.liveAllocations.load(std::memory_order_relaxed);
+    stats.totalAllocations = counters.totalAllocations.load(std::memory_order_relaxed);
+    stats.frameAllocations = counters.lastFrameAllocations;
+    stats.frameBytes = counters.lastFrameBytes;
+    return stats;
+}
+
+//===api=====================
+void *mem_malloc(MSG_CHANNEL tag, size_t size) {
+    MemHeader *header = (MemHeader *) malloc(sizeof(MemHeader) + size);
+    ASSERT_MSG(header != nullptr, "Err: failed to allocate %zu bytes", size);
+    header->size = size;
+    header->tagIndex = tag_to_index(tag);
+    header->magic = BEET_MEM_HEADER_MAGIC;
+    track_alloc(header->tagIndex, size);
+    return header + 1;
+}
+
+void *mem_calloc(MSG_CHANNEL tag, size_t size) {
+    void *memory = mem_malloc(tag, size);
+    memset(memory, 0, size);
+    return memory;
+}
+
+void mem_free(void *ptr) {
+    if (ptr == nullptr) {
+        return;
+    }
+    MemHeader *header = ((MemHeader *) ptr) - 1;
+    ASSERT_MSG(header->magic == BEET_MEM_HEADER_MAGIC, "Err: freeing memory that was not allocated through mem_malloc");
+    track_free(header->tagIndex, header->size);
+    header->magic = 0;
+    free(header);
+}
+
+MemTagStats mem_tracker_stats(MSG_CHANNEL tag) {
+    return counters_to_stats(s_memTags[tag_to_index(tag)]);
+}
+
+MemTagStats mem_tracker_total_stats() {
+    MemTagStats total{};
+    for (uint32_t i = 0; i < BEET_MEM_TAG_COUNT; ++i) {
+        const MemTagStats stats = counters_to_stats(s_memTags[i]);
+        total.liveBytes += stats.liveBytes;
+        total.peakBytes += stats.peakBytes;
+        total.liveAllocations += stats.liveAllocations;
+        total.totalAllocations += stats.totalAllocations;
+        total.frameAllocations += stats.frameAllocations;
+        total.frameBytes += stats.frameBytes;
+    }
+    return total;
+}
+
+void mem_tracker_next_frame() {
+    for (uint32_t i = 0; i < BEET_MEM_TAG_COUNT; ++i) {
+        MemTagCounters &counters = s_memTags[i];
+        counters.lastFrameAllocations = counters.frameAllocations.exchange(0, std::memory_order_relaxed);
+        counters.lastFrameBytes = counters.frameBytes.exchange(0, std::memory_order_relaxed);
+    }
+}
+
+void mem_tracker_log() {
+    for (uint32_t i = 0; i < BEET_MEM_TAG_COUNT; ++i) {
+        const MemTagStats stats = counters_to_stats(s_memTags[i]);
+        if (stats.totalAllocations == 0) {
+            continue;
+        }
+        // each tag reports on its own channel, untagged allocations report on the engine channel.
+        log_info((i == 0 ? MSG_ENGINE : (MSG_CHANNEL) (1u << i)), "memory live: %llu bytes (%llu allocs) peak: %llu bytes last frame: %llu allocs %llu bytes\n",
+                 (unsigned long long) stats.liveBytes,
+                 (unsigned long long) stats.liveAllocations,
+                 (unsigned long long) stats.peakBytes,
+                 (unsigned long long) stats.frameAllocations,
+                 (unsigned long long) stats.frameBytes);
+    }
+}
@@ -0,0 +1,257 @@
+#include <shared/profiler.h>
+#include <shared/assert.h>
+#include <shared/log.h>
+
+#if BEET_PROFILE
+
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+
+//===defines=================
+#define BEET_PROFILE_MAX_THREADS 64u
+#define BEET_PROFILE_EVENTS_PER_THREAD (1u << 15u)
+#define BEET_PROFILE_MAX_FRAMES 1024u
+
+//===internal structs========
+struct ProfileEvent {
+    const char *name;
+    uint64_t startNs;
+    uint64_t endNs;
+};
+
+// single producer ring, only the owning thread writes, the exporter reads up to the published write index.
+struct ProfileThreadBuffer {
+    ProfileEvent events[BEET_PROFILE_EVENTS_PER_THREAD];
+    std::atomic<uint64_t> writeIndex;
+    uint32_t threadId;
+    char name[32];
+};
+
+struct Profiler {
+    std::atomic<ProfileThreadBuffer *> threads[BEET_PROFILE_MAX_THREADS];
+    std::atomic<uint32_t> threadCount;
+
+    uint64_t frameStartNs[BEET_PROFILE_MAX_FRAMES];
+    std::atomic<uint32_t> frameCount;
+
+    uint64_t startNs;
+    uint32_t generation;
+};
+
+Profiler *g_profiler;
+
+static uint32_t s_profilerGeneration = 0;
+static thread_local ProfileThreadBuffer *s_threadBuffer = nullptr;
+static thread_local uint32_t s_threadBufferGeneration = 0;
+
+//===internal functions======
+static uint64_t profiler_now_ns() {
+    using namespace std::chrono;
+    return (uint64_t) duration_cast<nanoseconds>(steady_clock::now().time_since_epoch()).count();
+}
+
+static ProfileThreadBuffer *get_thread_buffer() {
+    if (s_threadBuffer != nullptr && s_threadBufferGeneration == g_profiler->generation) {
+        return s_threadBuffer;
+    }
+
+    // first scope on this thread, claim a slot without taking a lock.
+    const uint32_t slot = g_profiler->threadCount.fetch_add(1, std::memory_order_relaxed);
+    if (slot >= BEET_PROFILE_MAX_THREADS) {
+        g_profiler->threadCount.fetch_sub(1, std::memory_order_relaxed);
+        return nullptr;
+    }
+
+    ProfileThreadBuffer *buffer = new ProfileThreadBuffer;
+    buffer->writeIndex.store(0, std::memory_order_relaxed);
+    buffer->threadId = slot;
+    snprintf(buffer->name, sizeof(buffer->name), "thread %u", slot);
+    g_profiler->threads[slot].store(buffer, std::memory_order_release);
+
+    s_threadBuffer = buffer;
+    s_threadBufferGeneration = g_profiler->generation;
+    return buffer;
+}
+
+static void write_json_string(FILE *file, const char *str) {
+    fputc('"', file);
+    for (const char *c = str; *c != '\0'; ++c) {
+        if (*c == '"' || *c == '\\') {
+            fputc('\\', file);
+        }
+        fputc(*c, file);
+    }
+    fputc('"', file);
+}
+
+//===api=====================
+ProfileScope::ProfileScope(const char *name) : name(name), startNs(0) {
+    if (g_profiler != nullptr) {
+        startNs = profiler_now_ns();
+    }
+}
+
+ProfileScope::~ProfileScope() {
+    if (g_profiler == nullptr || startNs == 0) {
+        return;
+    }
+    ProfileThreadBuffer *buffer = get_thread_buffer();
+    if (buffer == nullptr) {
+        return;
+    }
+    const uint64_t index = buffer->writeIndex.load(std::memory_order_relaxed);
+    ProfileEvent &event = buffer->events[index % BEET_PROFILE_EVENTS_PER_THREAD];
+    event.name = name;
+    event.startNs = startNs;
+    event.endNs = profiler_now_ns();
+    buffer->writeIndex.store(index + 1, std::memory_order_release);
+}
+
+void profiler_frame_mark() {
+    if (g_profiler == nullptr) {
+        return;
+    }
+    const uint32_t frame = g_profiler->frameCount.load(std::memory_order_relaxed);
+    g_profiler->frameStartNs[frame % BEET_PROFILE_MAX_FRAMES] = profiler_now_ns();
+    g_profiler->frameCount.store(frame + 1, std::memory_order_release);
+}
+
+uint32_t profiler_frame_index() {
+    if (g_profiler == nullptr) {
+        return 0;
+    }
+    const uint32_t frameCount = g_profiler->frameCount.load(std::memory_order_acquire);
+    return frameCount > 0 ? frameCount - 1 : 0;
+}
+
+void profiler_set_thread_name(const char *name) {
+    if (g_profiler == nullptr) {
+        return;
+    }
+    ProfileThreadBuffer *buffer = get_thread_buffer();
+    if (buffer != nullptr) {
+        snprintf(buffer->name, sizeof(buffer->name), "%s", name);
+    }
+}
+
+bool profiler_export_chrome_trace(const char *path, uint32_t firstFrame, uint32_t lastFrame) {
+    ASSERT_MSG(g_profiler != nullptr, "Err: profiler_create has not been called");
+    ASSERT_MSG(firstFrame <= lastFrame, "Err: invalid frame range [%u, %u]", firstFrame, lastFrame);
+
+    // resolve the frame range into a time window.
+    const uint32_t frameCount = g_profiler->frameCount.load(std::memory_order_acquire);
+    uint64_t windowStartNs = 0;
+    uint64_t windowEndNs = UINT64_MAX;
+    if (frameCount > 0) {
+        const uint32_t oldestFrame = frameCount > BEET_PROFILE_MAX_FRAMES ? frameCount - BEET_PROFILE_MAX_FRAMES : 0;
+        firstFrame = firstFrame < oldestFrame ? oldestFrame : firstFrame;
+        firstFrame = firstFrame < frameCount - 1 ? firstFrame : frameCount - 1;
+        lastFrame = lastFrame < firstFrame ? firstFrame : lastFrame;
+        lastFrame = lastFrame < frameCount - 1 ? lastFrame : frameCount - 1;
+        windowStartNs = g_profiler->frameStartNs[firstFrame % BEET_PROFILE_MAX_FRAMES];
+        if (lastFrame + 1 < frameCount) {
+            windowEndNs = g_profiler->frameStartNs[(lastFrame + 1) % BEET_PROFILE_MAX_FRAMES];
+        }
+    }
+
+    FILE *file = fopen(path, "w");
+    if (file == nullptr) {
+        log_error(MSG_DBG, "failed to open profiler trace: %s \n", path);
+        return false;
+    }
+
+    const double startNs = (double) g_profiler->startNs;
+    bool firstEvent = true;
+    fprintf(file, "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n");
+
+    if (frameCount > 0) {
+        for (uint32_t frame = firstFrame; frame <= lastFrame; ++frame) {
+            const double ts = ((double) g_profiler->frameStartNs[frame % BEET_PROFILE_MAX_FRAMES] - startNs) / 1000.0;
+            fprintf(file, "%s{\"name\":\"frame %u\",\"ph\":\"i\",\"s\":\"g\",\"pid\":0,\"tid\":0,\"ts\":%.3f}", firstEvent ? "" : ",\n", frame, ts);
+            firstEvent = false;
+        }
+    }
+
+    const uint32_t threadCount = g_profiler->threadCount.load(std::memory_order_acquire);
+    for (uint32_t i = 0; i < threadCount && i < BEET_PROFILE_MAX_THREADS; ++i) {
+        const ProfileThreadBuffer *buffer = g_profiler->threads[i].load(std::memory_order_acquire);
+        if (buffer == nullptr) {
+            continue;
+        }
+
+        fprintf(file, "%s{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":0,\"tid\":%u,\"args\":{\"name\":", firstEvent ? "" : ",\n", buffer->threadId);
+        write_json_string(file, buffer->name);
+        fprintf(file, "}}");
+        firstEvent = false;
+
+        const uint64_t writeIndex = buffer->writeIndex.load(std::memory_order_acquire);
+        const uint64_t readIndex = writeIndex > BEET_PROFILE_EVENTS_PER_THREAD ? writeIndex - BEET_PROFILE_EVENTS_PER_THREAD : 0;
+        for (uint64_t e = readIndex; e < writeIndex; ++e) {
+            const ProfileEvent &event = buffer->events[e % BEET_PROFILE_EVENTS_PER_THREAD];
+            if (event.endNs < windowStartNs || event.startNs > windowEndNs) {
+                continue;
+            }
+            fprintf(file, ",\n{\"name\":");
+            write_json_string(file, event.name);
+            fprintf(file, ",\"ph\":\"X\",\"pid\":0,\"tid\":%u,\"ts\":%.3f,\"dur\":%.3f}",
+                    buffer->threadId,
+                    ((double) event.startNs - startNs) / 1000.0,
+                    (double) (event.endNs - event.startNs) / 1000.0);
+        }
+    }
+
+    fprintf(file, "\n]}\n");
+    fclose(file);
+    log_info(MSG_DBG, "wrote profiler trace: %s \n", path);
+    return true;
+}
+
+//===init & shutdown=========
+void profiler_create() {
+    g_profiler = new Profiler;
+    for (uint32_t i = 0; i < BEET_PROFILE_MAX_THREADS; ++i) {
+        g_profiler->threads[i].store(nullptr, std::memory_order_relaxed);
+    }
+    g_profiler->threadCount.store(0, std::memory_order_relaxed);
+    g_profiler->frameCount.store(0, std::memory_order_relaxed);
+    g_profiler->startNs = profiler_now_ns();
+    g_profiler->generation = ++s_profilerGeneration;
+}
+
+void profiler_cleanup() {
+    // all instrumented threads must have stopped recording before this point.
+    Profiler *profiler = g_profiler;
+    g_profiler = nullptr;
+    for (uint32_t i = 0; i < BEET_PROFILE_MAX_THREADS; ++i) {
+        delete profiler->threads[i].load(std::memory_order_acquire);
+    }
+    delete profiler;
+}
+
+#else
+
+//===api=====================
+ProfileScope::ProfileScope(const char *name) : name(name), startNs(0) {}
+
+ProfileScope::~ProfileScope() {}
+
+void profiler_frame_mark() {}
+
+uint32_t profiler_frame_index() {
+    return 0;
+}
+
+void profiler_set_thread_name(const char *name) {}
+
+bool profiler_export_chrome_trace(const char *path, uint32_t firstFrame, uint32_t lastFrame) {
+    return false;
+}
+
+//===init & shutdown=========
+void profiler_create() {}
+
+void profiler_cleanup() {}
+
+#endif
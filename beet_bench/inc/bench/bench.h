@@ -0,0 +1,46 @@
+#ifndef BEETROOT_BENCH_H
+#define BEETROOT_BENCH_H
+
+#include <cstdint>
+
+//===public structs==========
+struct BenchDesc {
+    const char *name;
+    uint32_t warmupRuns;
+    uint32_t runs;
+
+    // work items processed by a single run, used to report throughput. 0 skips throughput.
+    uint64_t itemsPerRun;
+
+    // optional, called before every warm-up & timed run without being timed.
+    void (*setup)();
+    void (*run)();
+};
+
+struct BenchResult {
+    const char *name;
+    uint32_t warmupRuns;
+    uint32_t runs;
+    uint64_t itemsPerRun;
+
+    double minMs;
+    double meanMs;
+    double p50Ms;
+    double p90Ms;
+    double p99Ms;
+    double maxMs;
+    double itemsPerSecond;
+};
+
+//===api=====================
+BenchResult bench_run(const BenchDesc &desc);
+
+void bench_print(const BenchResult &result);
+
+// writes every result as a single json document, tagged with the commit the bench was built from.
+bool bench_write_json(const char *path, const BenchResult *results, uint32_t resultCount);
+
+// keeps the compiler from discarding work whose result is otherwise unused.
+void bench_do_not_optimize(const void *ptr);
+
+#endif //BEETROOT_BENCH_H
@@ -0,0 +1,345 @@
+#include <bench/bench.h>
+
+#include <pipeline/font_atlas.h>
+#include <pipeline/pipeline_commandlines.h>
+#include <pipeline/pipeline_defines.h>
+
+#include <gfx/gfx_resource_db.h>
+
+#include <shared/dds_loader.h>
+#include <shared/db_types.h>
+#include <shared/log.h>
+#include <shared/mem_tracker.h>
+#include <shared/ecs.h>
+
+#include <math/mat4.h>
+#include <math/quat.h>
+#include <math/transform_batch.h>
+
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <string>
+#include <thread>
+#include <vector>
+
+//===defines=================
+#define BENCH_MAX_CASES 32u
+#define BENCH_MODEL_MATRIX_COUNT 10000u
+#define BENCH_COMMANDLINE_PARSES 1000u
+#define BENCH_GLYPH_TEXT_REPEATS 64u
+#define BENCH_DB_ENTITY_COUNT 16384u
+#define BENCH_ECS_ENTITY_COUNT 100000u
+#define BENCH_LOADER_THREADS 4u
+// one in this many transforms is written per run of the world matrix case, the rest stay static.
+#define BENCH_DYNAMIC_TRANSFORM_STRIDE 100u
+
+//===internal structs========
+struct BenchState {
+    std::vector<std::string> ddsPaths;
+    // stands in for mapped staging memory, sized to the largest payload so no run allocates.
+    std::vector<unsigned char> ddsStaging;
+
+    std::vector<Transform> transforms;
+    std::vector<mat4> modelMatrices;
+    // the same transforms split into position, rotation & scale streams, 9 floats per transform.
+    std::vector<float> transformStreams;
+
+    std::vector<DbHandle> transformHandles;
+    std::vector<DbHandle> meshHandles;
+    std::vector<Entity> entities;
+
+    AtlasInfo *atlasInfo;
+    std::string glyphText;
+};
+
+static BenchState s_bench{};
+
+//===bench cases=============
+static void bench_dds_load_run() {
+    for (const std::string &path: s_bench.ddsPaths) {
+        RawImage image{};
+        load_dds_image(path.c_str(), &image);
+        bench_do_not_optimize(image.data);
+        release_dds_image(&image);
+    }
+}
+
+static void bench_dds_map_run() {
+    // touches every mip the way the staging copy does, so the page faults are part of the measurement.
+    uint64_t sum = 0;
+    for (const std::string &path: s_bench.ddsPaths) {
+        RawImage image{};
+        map_dds_image(path.c_str(), &image);
+        const unsigned char *bytes = (const unsigned char *) image.data;
+        for (uint32_t i = 0; i < image.dataSize; i += 4096) {
+            sum += bytes[i];
+        }
+        release_dds_image(&image);
+    }
+    bench_do_not_optimize(&sum);
+}
+
+static void bench_dds_read_payload_run() {
+    for (const std::string &path: s_bench.ddsPaths) {
+        RawImage image{};
+        query_dds_image(path.c_str(), &image);
+        read_dds_payload(path.c_str(), &image, s_bench.ddsStaging.data(), s_bench.ddsStaging.size());
+        bench_do_not_optimize(s_bench.ddsStaging.data());
+    }
+}
+
+static void bench_font_atlas_setup() {
+    // the atlas is cached on disk by timestamp, force a full rebuild on every run.
+    const char *args[] = {"beet_bench", "-ignoreConvertCache"};
+    commandline_init(2, (char **) args);
+}
+
+static void bench_font_atlas_run() {
+    pipeline_build_font_atlas("fonts/JetBrainsMono/JetBrainsMono-Regular", ".ttf", 48, 512);
+}
+
+static void bench_db_setup() {
+    // default capacities, so every run also pays for growing past them.
+    gfx_db_cleanup();
+    gfx_db_create();
+}
+
+static void bench_db_run() {
+    for (uint32_t i = 0; i < BENCH_DB_ENTITY_COUNT; ++i) {
+        const Transform transform{{(float) i, 0.0f, 0.0f}};
+        s_bench.transformHandles[i] = gfx_db_add_transform(transform);
+    }
+    for (uint32_t i = 0; i < BENCH_DB_ENTITY_COUNT; ++i) {
+        s_bench.entities[i] = ecs_create_entity();
+        ecs_add(s_bench.entities[i], TransformComponent{s_bench.transformHandles[i]});
+    }
+    for (uint32_t i = 0; i < BENCH_DB_ENTITY_COUNT; ++i) {
+        const TransformComponent *component = ecs_get<TransformComponent>(s_bench.entities[i]);
+        const Transform transform = gfx_db_get_transform(component->transformHandle);
+        bench_do_not_optimize(&transform);
+    }
+    for (uint32_t i = 0; i < BENCH_DB_ENTITY_COUNT; ++i) {
+        ecs_destroy_entity(s_bench.entities[i]);
+    }
+}
+
+static void bench_db_concurrent_run() {
+    // loaders fill the mesh table past its default capacity, the overflow is written by the commit.
+    std::thread loaders[BENCH_LOADER_THREADS];
+    for (uint32_t t = 0; t < BENCH_LOADER_THREADS; ++t) {
+        loaders[t] = std::thread([t]() {
+            for (uint32_t i = t; i < BENCH_DB_ENTITY_COUNT; i += BENCH_LOADER_THREADS) {
+                GfxMesh mesh{};
+                mesh.indexCount = i;
+                s_bench.meshHandles[i] = gfx_db_add_mesh_concurrent(mesh);
+            }
+        });
+    }
+    for (std::thread &loader: loaders) {
+        loader.join();
+    }
+    gfx_db_commit_concurrent_adds();
+    bench_do_not_optimize(gfx_db_get_mesh(s_bench.meshHandles[BENCH_DB_ENTITY_COUNT - 1]));
+}
+
+static void bench_ecs_each_setup() {
+    // every entity has a transform & mesh, every other one a lit material, so the view skips half of them.
+    if (ecs_entity_count() == BENCH_ECS_ENTITY_COUNT) {
+        return;
+    }
+    ecs_cleanup();
+    ecs_create();
+    for (uint32_t i = 0; i < BENCH_ECS_ENTITY_COUNT; ++i) {
+        const Entity entity = ecs_create_entity();
+        ecs_add(entity, TransformComponent{DbHandle{i, 1}});
+        ecs_add(entity, MeshComponent{DbHandle{i % 16, 1}});
+        if (i % 2 == 0) {
+            ecs_add(entity, LitMaterialComponent{DbHandle{i % 4, 1}});
+        }
+    }
+}
+
+static void bench_ecs_each_run() {
+    uint64_t sum = 0;
+    ecs_each<TransformComponent, MeshComponent, LitMaterialComponent>([&](Entity, const TransformComponent &transform, const MeshComponent &mesh,
+                                                                          const LitMaterialComponent &material) {
+        sum += transform.transformHandle.index + mesh.meshHandle.index + material.materialHandle.index;
+    });
+    bench_do_not_optimize(&sum);
+}
+
+static void bench_world_matrices_setup() {
+    gfx_db_cleanup();
+    gfx_db_create();
+    for (uint32_t i = 0; i < BENCH_DB_ENTITY_COUNT; ++i) {
+        const Transform transform{{(float) i, 0.0f, 0.0f}};
+        s_bench.transformHandles[i] = gfx_db_add_transform(transform);
+    }
+    gfx_db_update_world_matrices();
+}
+
+static void bench_world_matrices_run() {
+    for (uint32_t i = 0; i < BENCH_DB_ENTITY_COUNT; i += BENCH_DYNAMIC_TRANSFORM_STRIDE) {
+        Transform transform = gfx_db_get_transform(s_bench.transformHandles[i]);
+        transform.rotation.y += 0.01f;
+        gfx_db_set_transform(s_bench.transformHandles[i], transform);
+    }
+    const uint32_t updated = gfx_db_update_world_matrices();
+    bench_do_not_optimize(&updated);
+}
+
+static void bench_model_matrix_run() {
+    // matches the per entity model matrix built by the lit & font passes.
+    for (uint32_t i = 0; i < BENCH_MODEL_MATRIX_COUNT; ++i) {
+        const Transform &transform = s_bench.transforms[i];
+        s_bench.modelMatrices[i] = translate(mat4(1.0f), transform.position) * toMat4(quat(transform.rotation)) * scale(mat4(1.0f), transform.scale);
+    }
+    bench_do_not_optimize(s_bench.modelMatrices.data());
+}
+
+static void bench_model_matrix_batch_run() {
+    const float *stream = s_bench.transformStreams.data();
+    const uint32_t count = BENCH_MODEL_MATRIX_COUNT;
+    const TransformStreams streams{
+            stream + count * 0, stream + count * 1, stream + count * 2,
+            stream + count * 3, stream + count * 4, stream + count * 5,
+            stream + count * 6, stream + count * 7, stream + count * 8,
+    };
+    transform_batch_world_matrices(streams, count, s_bench.modelMatrices.data());
+    bench_do_not_optimize(s_bench.modelMatrices.data());
+}
+
+static void bench_glyph_lookup_setup() {
+    if (s_bench.atlasInfo == nullptr) {
+        s_bench.atlasInfo = pipeline_load_atlas_info(CLIENT_RUNTIME_FONT_DIR "JetBrainsMono/JetBrainsMono-Regular.desc");
+    }
+}
+
+static void bench_glyph_lookup_run() {
+    const AtlasInfo *atlasInfo = s_bench.atlasInfo;
+    for (const char character: s_bench.glyphText) {
+        const GlyphInfo *found = nullptr;
+        for (uint32_t i = 0; i < atlasInfo->glyphCount; ++i) {
+            if (atlasInfo->glyphs[i].glyph == (uint32_t) character) {
+                found = &atlasInfo->glyphs[i];
+                break;
+            }
+        }
+        bench_do_not_optimize(found);
+    }
+}
+
+static void bench_commandline_run() {
+    const char *args[] = {"beet_pipeline", "-help", "-ignoreConvertCache", "-unknown", "path/to/file", "-help", "-ignoreConvertCache", "-help"};
+    for (uint32_t i = 0; i < BENCH_COMMANDLINE_PARSES; ++i) {
+        commandline_init(sizeof(args) / sizeof(args[0]), (char **) args);
+    }
+}
+
+//===internal functions======
+static void bench_gather_dds_paths() {
+    std::error_code error;
+    for (const auto &entry: std::filesystem::recursive_directory_iterator(CLIENT_RUNTIME_RES_DIR, error)) {
+        if (entry.is_regular_file() && entry.path().extension() == ".dds") {
+            s_bench.ddsPaths.push_back(entry.path().string());
+        }
+    }
+    size_t largestPayload = 0;
+    for (const std::string &path: s_bench.ddsPaths) {
+        RawImage image{};
+        query_dds_image(path.c_str(), &image);
+        largestPayload = image.dataSize > largestPayload ? image.dataSize : largestPayload;
+    }
+    s_bench.ddsStaging.resize(largestPayload);
+    if (s_bench.ddsPaths.empty()) {
+        log_warning(MSG_BENCH, "no .dds files found in %s, run beet_pipeline first\n", CLIENT_RUNTIME_RES_DIR);
+    }
+}
+
+static void bench_create() {
+    bench_gather_dds_paths();
+
+    s_bench.transformHandles.resize(BENCH_DB_ENTITY_COUNT);
+    s_bench.meshHandles.resize(BENCH_DB_ENTITY_COUNT);
+    s_bench.entities.resize(BENCH_DB_ENTITY_COUNT);
+    ecs_create();
+
+    s_bench.transforms.resize(BENCH_MODEL_MATRIX_COUNT);
+    s_bench.modelMatrices.resize(BENCH_MODEL_MATRIX_COUNT);
+    s_bench.transformStreams.resize(BENCH_MODEL_MATRIX_COUNT * 9);
+    for (uint32_t i = 0; i < BENCH_MODEL_MATRIX_COUNT; ++i) {
+        const float f = (float) i;
+        const Transform transform{{f, f * 0.5f, -f}, {f * 0.01f, f * 0.02f, f * 0.03f}, {1.0f, 2.0f, 1.0f}};
+        s_bench.transforms[i] = transform;
+        const float components[9] = {
+                transform.position.x, transform.position.y, transform.position.z,
+                transform.rotation.x, transform.rotation.y, transform.rotation.z,
+                transform.scale.x, transform.scale.y, transform.scale.z,
+        };
+        for (uint32_t c = 0; c < 9; ++c) {
+            s_bench.transformStreams[c * BENCH_MODEL_MATRIX_COUNT + i] = components[c];
+        }
+    }
+
+    for (uint32_t i = 0; i < BENCH_GLYPH_TEXT_REPEATS; ++i) {
+        s_bench.glyphText += "The quick brown fox jumps over the lazy dog 0123456789 !?#@ ";
+    }
+}
+
+static void bench_cleanup() {
+    gfx_db_cleanup();
+    ecs_cleanup();
+    if (s_bench.atlasInfo != nullptr) {
+        mem_delete_array(s_bench.atlasInfo->glyphs, s_bench.atlasInfo->glyphCount);
+        mem_delete(s_bench.atlasInfo);
+        s_bench.atlasInfo = nullptr;
+    }
+}
+
+int32_t main(int32_t argc, char **argv) {
+    const char *outPath = "bench_results.json";
+    const char *filter = nullptr;
+    for (int32_t i = 1; i < argc; ++i) {
+        if (strcmp(argv[i], "-out") == 0 && i + 1 < argc) {
+            outPath = argv[++i];
+        } else if (strcmp(argv[i], "-filter") == 0 && i + 1 < argc) {
+            filter = argv[++i];
+        }
+    }
+
+    bench_create();
+
+    const BenchDesc cases[] = {
+            {"commandline_parse", 10, 200, BENCH_COMMANDLINE_PARSES, nullptr, bench_commandline_run},
+            {"pipeline_build_font_atlas", 1, 5, 1, bench_font_atlas_setup, bench_font_atlas_run},
+            {"glyph_lookup", 10, 200, (uint64_t) s_bench.glyphText.size(), bench_glyph_lookup_setup, bench_glyph_lookup_run},
+            {"load_dds_image", 2, 20, (uint64_t) s_bench.ddsPaths.size(), nullptr, bench_dds_load_run},
+            {"map_dds_image", 2, 20, (uint64_t) s_bench.ddsPaths.size(), nullptr, bench_dds_map_run},
+            {"read_dds_payload", 2, 20, (uint64_t) s_bench.ddsPaths.size(), nullptr, bench_dds_read_payload_run},
+            {"db_add_get_remove", 10, 200, BENCH_DB_ENTITY_COUNT * 4, bench_db_setup, bench_db_run},
+            {"db_add_mesh_concurrent", 10, 200, BENCH_DB_ENTITY_COUNT, bench_db_setup, bench_db_concurrent_run},
+            {"ecs_each_lit_view", 10, 200, BENCH_ECS_ENTITY_COUNT, bench_ecs_each_setup, bench_ecs_each_run},
+            {"db_world_matrices_mostly_static", 10, 200, BENCH_DB_ENTITY_COUNT, bench_world_matrices_setup, bench_world_matrices_run},
+            {"model_matrix", 10, 200, BENCH_MODEL_MATRIX_COUNT, nullptr, bench_model_matrix_run},
+            {"model_matrix_batch", 10, 200, BENCH_MODEL_MATRIX_COUNT, nullptr, bench_model_matrix_batch_run},
+    };
+
+    BenchResult results[BENCH_MAX_CASES] = {};
+    uint32_t resultCount = 0;
+    for (const BenchDesc &desc: cases) {
+        if (filter != nullptr && strstr(desc.name, filter) == nullptr) {
+            continue;
+        }
+        if (desc.itemsPerRun == 0) {
+            log_warning(MSG_BENCH, "skipping %s, nothing to run\n", desc.name);
+            continue;
+        }
+        results[resultCount] = bench_run(desc);
+        bench_print(results[resultCount]);
+        resultCount++;
+    }
+
+    bench_cleanup();
+    return bench_write_json(outPath, results, resultCount) ? 0 : 1;
+}
@@ -0,0 +1,100 @@
+#include <bench/bench.h>
+
+#include <shared/assert.h>
+#include <shared/log.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <vector>
+
+//===internal functions======
+static double bench_now_ms() {
+    using namespace std::chrono;
+    return duration<double, std::milli>(steady_clock::now().time_since_epoch()).count();
+}
+
+// nearest rank percentile over already sorted samples.
+static double percentile(const std::vector<double> &sortedSamples, const double percent) {
+    const size_t rank = (size_t) ((percent / 100.0) * (double) (sortedSamples.size() - 1) + 0.5);
+    return sortedSamples[std::min(rank, sortedSamples.size() - 1)];
+}
+
+//===api=====================
+BenchResult bench_run(const BenchDesc &desc) {
+    ASSERT_MSG(desc.run != nullptr, "Err: bench %s has no run function", desc.name);
+    ASSERT_MSG(desc.runs > 0, "Err: bench %s needs at least one run", desc.name);
+
+    for (uint32_t i = 0; i < desc.warmupRuns; ++i) {
+        if (desc.setup) {
+            desc.setup();
+        }
+        desc.run();
+    }
+
+    std::vector<double> samples(desc.runs);
+    double totalMs = 0.0;
+    for (uint32_t i = 0; i < desc.runs; ++i) {
+        if (desc.setup) {
+            desc.setup();
+        }
+        const double start = bench_now_ms();
+        desc.run();
+        samples[i] = bench_now_ms() - start;
+        totalMs += samples[i];
+    }
+    std::sort(samples.begin(), samples.end());
+
+    BenchResult result{};
+    result.name = desc.name;
+    result.warmupRuns = desc.warmupRuns;
+    result.runs = desc.runs;
+    result.itemsPerRun = desc.itemsPerRun;
+    result.minMs = samples.front();
+    result.meanMs = totalMs / (double) desc.runs;
+    result.p50Ms = percentile(samples, 50.0);
+    result.p90Ms = percentile(samples, 90.0);
+    result.p99Ms = percentile(samples, 99.0);
+    result.maxMs = samples.back();
+    if (desc.itemsPerRun > 0 && result.p50Ms > 0.0) {
+        result.itemsPerSecond = (double) desc.itemsPerRun / (result.p50Ms / 1000.0);
+    }
+    return result;
+}
+
+void bench_print(const BenchResult &result) {
+    // printed rather than logged, the results are the output of the tool and must survive release builds.
+    printf("%-28s runs: %4u min: %9.4fms p50: %9.4fms p90: %9.4fms p99: %9.4fms max: %9.4fms",
+           result.name, result.runs, result.minMs, result.p50Ms, result.p90Ms, result.p99Ms, result.maxMs);
+    if (result.itemsPerSecond > 0.0) {
+        printf(" items/s: %.0f", result.itemsPerSecond);
+    }
+    printf("\n");
+}
+
+bool bench_write_json(const char *path, const BenchResult *results, uint32_t resultCount) {
+    FILE *file = fopen(path, "w");
+    if (file == nullptr) {
+        log_error(MSG_BENCH, "failed to open bench output: %s \n", path);
+        return false;
+    }
+
+    fprintf(file, "{\n\t\"commit\": \"%s\",\n\t\"buildType\": \"%s\",\n\t\"results\": [\n", BEET_BENCH_GIT_HASH, BEET_BENCH_BUILD_TYPE);
+    for (uint32_t i = 0; i < resultCount; ++i) {
+        const BenchResult &result = results[i];
+        fprintf(file, "\t\t{\"name\": \"%s\", \"warmupRuns\": %u, \"runs\": %u, \"itemsPerRun\": %llu, "
+                      "\"minMs\": %.6f, \"meanMs\": %.6f, \"p50Ms\": %.6f, \"p90Ms\": %.6f, \"p99Ms\": %.6f, \"maxMs\": %.6f, "
+                      "\"itemsPerSecond\": %.3f}%s\n",
+                result.name, result.warmupRuns, result.runs, (unsigned long long) result.itemsPerRun,
+                result.minMs, result.meanMs, result.p50Ms, result.p90Ms, result.p99Ms, result.maxMs,
+                result.itemsPerSecond, i + 1 < resultCount ? "," : "");
+    }
+    fprintf(file, "\t]\n}\n");
+    fclose(file);
+    return true;
+}
+
+void bench_do_not_optimize(const void *ptr) {
+    static const void *volatile s_sink = nullptr;
+    s_sink = ptr;
+}
@@ -17,4 +17,7 @@
 #define PIPELINE_TEXTURE_DIR PIPELINE_RES_DIR "textures/"
 #define CLIENT_RUNTIME_TEXTURE_DIR BEET_CMAKE_CLIENT_RES_DIR "textures/"
 
+//===scenes==================
+#define CLIENT_RUNTIME_SCENE_DIR BEET_CMAKE_CLIENT_RES_DIR "scenes/"
+
 #endif //BEETROOT_PIPELINE_DEFINES_H
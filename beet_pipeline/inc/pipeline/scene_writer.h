@@ -0,0 +1,55 @@
+#ifndef BEETROOT_SCENE_WRITER_H
+#define BEETROOT_SCENE_WRITER_H
+
+#include <shared/scene_format.h>
+
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+// collects a scene in the layout of shared/scene_format.h, every add returns the index later adds refer to.
+struct SceneWriter {
+    uint32_t entityCount;
+
+    std::vector<Transform> transforms;
+    std::vector<uint32_t> transformParents;
+    std::vector<UiTransform> uiTransforms;
+    std::vector<Camera> cameras;
+    std::vector<SceneMesh> meshes;
+    std::vector<SceneTexture> textures;
+    std::vector<SceneLitMaterial> litMaterials;
+    std::vector<SceneFontMaterial> fontMaterials;
+    std::vector<char> strings;
+    std::unordered_map<std::string, uint32_t> textureIndices;
+
+    std::vector<SceneComponentRef> transformComponents;
+    std::vector<SceneComponentRef> uiTransformComponents;
+    std::vector<SceneComponentRef> cameraComponents;
+    std::vector<SceneComponentRef> meshComponents;
+    std::vector<SceneComponentRef> litMaterialComponents;
+    std::vector<SceneComponentRef> fontMaterialComponents;
+};
+
+uint32_t scene_writer_add_entity(SceneWriter &writer);
+
+// parent is the index of an already added transform, so the loader never sees a child before its parent.
+uint32_t scene_writer_add_transform(SceneWriter &writer, const Transform &transform, uint32_t parent = SCENE_NONE);
+uint32_t scene_writer_add_ui_transform(SceneWriter &writer, const UiTransform &uiTransform);
+uint32_t scene_writer_add_camera(SceneWriter &writer, const Camera &camera);
+uint32_t scene_writer_add_mesh(SceneWriter &writer, SceneMeshSource source);
+// path as the client loads it, adding the same path twice returns the same index.
+uint32_t scene_writer_add_texture(SceneWriter &writer, const std::string &path);
+uint32_t scene_writer_add_lit_material(SceneWriter &writer, uint32_t albedoTexture);
+uint32_t scene_writer_add_font_material(SceneWriter &writer, uint32_t atlasTexture);
+
+void scene_writer_add_transform_component(SceneWriter &writer, uint32_t entity, uint32_t transform);
+void scene_writer_add_ui_transform_component(SceneWriter &writer, uint32_t entity, uint32_t uiTransform);
+void scene_writer_add_camera_component(SceneWriter &writer, uint32_t entity, uint32_t camera);
+void scene_writer_add_mesh_component(SceneWriter &writer, uint32_t entity, uint32_t mesh);
+void scene_writer_add_lit_material_component(SceneWriter &writer, uint32_t entity, uint32_t litMaterial);
+void scene_writer_add_font_material_component(SceneWriter &writer, uint32_t entity, uint32_t fontMaterial);
+
+// writes to CLIENT_RUNTIME_SCENE_DIR + writePath.
+void pipeline_write_scene(const SceneWriter &writer, const std::string &writePath);
+
+#endif //BEETROOT_SCENE_WRITER_H
@@ -2,13 +2,16 @@
 #include <pipeline/shader_compile.h>
 #include <pipeline/texture_compression.h>
 #include <pipeline/pipeline_commandlines.h>
+#include <pipeline/scene_writer.h>
 
 #include <shared/log.h>
 #include <shared/texture_formats.h>
+#include <shared/profiler.h>
 
 #include <fmt/format.h>
 
 void build_font_atlas_and_description() {
+    BEET_PROFILE_SCOPE("build_font_atlas_and_description");
     pipeline_font_atlas_log();
     {
         pipeline_build_font_atlas("fonts/JetBrainsMono/JetBrainsMono-Regular", ".ttf", 48, 512);
@@ -17,6 +20,7 @@ void build_font_atlas_and_description() {
 }
 
 void build_spv_from_source() {
+    BEET_PROFILE_SCOPE("build_spv_from_source");
     pipeline_shader_log();
     {
         pipeline_build_shader_spv("shaders/lit/lit.vert", "shaders/lit/lit.vert.spv");
@@ -29,6 +33,7 @@ void build_spv_from_source() {
 }
 
 void build_compressed_textures() {
+    BEET_PROFILE_SCOPE("build_compressed_textures");
     // compress generated font atlas.
     pipeline_build_compressed_textures("fonts/JetBrainsMono/JetBrainsMono-Regular.png", "fonts/JetBrainsMono/JetBrainsMono-Regular.dds", TextureFormat::BC7, false, true);
 
@@ -39,6 +44,53 @@ void build_compressed_textures() {
 
 }
 
+void build_scenes() {
+    BEET_PROFILE_SCOPE("build_scenes");
+    // same content as client_build_entities, which the client falls back to when the scene is missing.
+    SceneWriter scene{};
+    {
+        Transform transform{};
+        transform.position = vec3f{0.0f, 0.0f, -1.0f};
+
+        const uint32_t camera = scene_writer_add_entity(scene);
+        scene_writer_add_transform_component(scene, camera, scene_writer_add_transform(scene, transform));
+        scene_writer_add_camera_component(scene, camera, scene_writer_add_camera(scene, Camera{}));
+    }
+    {
+        const uint32_t uvTestTexture = scene_writer_add_texture(scene, "../res/textures/UV_Grid/UV_Grid_test.dds");
+        const uint32_t material = scene_writer_add_lit_material(scene, uvTestTexture);
+        const uint32_t cube = scene_writer_add_mesh(scene, SceneMeshSource::Cube);
+
+        const vec3f positions[] = {{0.0f, -2.0f, -8.0f}, {-2.0f, 1.0f, -12.0f}};
+        for (const vec3f &position: positions) {
+            Transform transform{};
+            transform.position = position;
+
+            const uint32_t entity = scene_writer_add_entity(scene);
+            scene_writer_add_transform_component(scene, entity, scene_writer_add_transform(scene, transform));
+            scene_writer_add_mesh_component(scene, entity, cube);
+            scene_writer_add_lit_material_component(scene, entity, material);
+        }
+    }
+    {
+        const uint32_t fontAtlasTexture = scene_writer_add_texture(scene, "../res/fonts/JetBrainsMono/JetBrainsMono-Regular.dds");
+
+        UiTransform transform{};
+        transform.position.x = -.5;
+        transform.position.y = 0;
+        transform.scale.x = 1.0f;
+        transform.scale.y = 1.0f;
+        transform.size.x = 400;
+        transform.size.y = 400;
+
+        const uint32_t text = scene_writer_add_entity(scene);
+        scene_writer_add_ui_transform_component(scene, text, scene_writer_add_ui_transform(scene, transform));
+        scene_writer_add_mesh_component(scene, text, scene_writer_add_mesh(scene, SceneMeshSource::Plane));
+        scene_writer_add_font_material_component(scene, text, scene_writer_add_font_material(scene, fontAtlasTexture));
+    }
+    pipeline_write_scene(scene, "default.bscene");
+}
+
 int32_t main(int32_t argc, char **argv) {
     commandline_init(argc, argv);
     if(commandline_get_arg(CLArgs::help).enabled){
@@ -46,7 +98,17 @@ int32_t main(int32_t argc, char **argv) {
         return 0;
     }
 
-    build_font_atlas_and_description();
-    build_spv_from_source();
-    build_compressed_textures();
+    profiler_create();
+    BEET_PROFILE_THREAD_NAME("pipeline");
+    {
+        BEET_PROFILE_SCOPE("pipeline");
+        build_font_atlas_and_description();
+        build_spv_from_source();
+        build_compressed_textures();
+        build_scenes();
+    }
+#if BEET_PROFILE
+    profiler_export_chrome_trace("pipeline_trace.json", 0, UINT32_MAX);
+#endif
+    profiler_cleanup();
 }
\ No newline at end of file
@@ -7,6 +7,8 @@
 
 #include <shared/log.h>
 #include <shared/assert.h>
+#include <shared/profiler.h>
+#include <shared/mem_tracker.h>
 #include <cstdio>
 
 #define STB_IMAGE_WRITE_IMPLEMENTATION
@@ -22,6 +24,7 @@ void pipeline_build_font_atlas(const std::string &fontName,
                                const std::string &fontExt,
                                uint32_t fontSize,
                                uint32_t atlasSize) {
+    BEET_PROFILE_SCOPE("pipeline_build_font_atlas");
 
     const std::string readPath = PIPELINE_RES_DIR;
     const std::string savePath = CLIENT_RUNTIME_RES_DIR;
@@ -160,12 +163,12 @@ void pipeline_save_atlas_info(const AtlasInfo *header, const std::string &fileSr
 }
 
 AtlasInfo *pipeline_load_atlas_info(const std::string &fileSrc) {
-    AtlasInfo *atlasInfo = new AtlasInfo;
+    AtlasInfo *atlasInfo = mem_new<AtlasInfo>(MSG_PIPELINE);
     FILE *fileRead = fopen(fileSrc.c_str(), "rb");
     ASSERT_MSG(fileRead != nullptr, "Err: failed to load atlas info at path: %s ", fileSrc.c_str())
 
     fread(atlasInfo, sizeof(AtlasInfo), 1, fileRead);
-    atlasInfo->glyphs = new GlyphInfo[atlasInfo->glyphCount];
+    atlasInfo->glyphs = mem_new_array<GlyphInfo>(MSG_PIPELINE, atlasInfo->glyphCount);
     fread(&atlasInfo->glyphs[0], sizeof(GlyphInfo) * atlasInfo->glyphCount, 1, fileRead);
 
     fclose(fileRead);
@@ -176,8 +179,8 @@ AtlasInfo *pipeline_load_atlas_info(const std::string &fileSrc) {
 void test_load_atlas_info() {
     pipeline_build_font_atlas("JetBrainsMono-Regular", ".ttf", 48, 512);
     auto info = pipeline_load_atlas_info(CLIENT_RUNTIME_FONT_DIR "JetBrainsMono-Regular" ".desc");
-    delete[] info->glyphs;
-    delete info;
+    mem_delete_array(info->glyphs, info->glyphCount);
+    mem_delete(info);
 }
 
 void pipeline_font_atlas_log() {
@@ -0,0 +1,165 @@
+#include <pipeline/scene_writer.h>
+#include <pipeline/pipeline_defines.h>
+
+#include <shared/assert.h>
+#include <shared/log.h>
+#include <shared/profiler.h>
+
+#include <cstdio>
+#include <filesystem>
+#include <fmt/format.h>
+
+//===internal functions======
+static uint64_t align_offset(const uint64_t offset) {
+    return (offset + SCENE_SECTION_ALIGNMENT - 1) & ~(uint64_t) (SCENE_SECTION_ALIGNMENT - 1);
+}
+
+static void add_component(std::vector<SceneComponentRef> &components, const uint32_t entityCount, const uint32_t entity,
+                          const uint32_t resource, const size_t resourceCount) {
+    ASSERT_MSG(entity < entityCount, "Err: scene entity %u out of range [%u]", entity, entityCount);
+    ASSERT_MSG(resource < resourceCount, "Err: scene resource %u out of range [%zu]", resource, resourceCount);
+    components.push_back(SceneComponentRef{entity, resource});
+}
+
+struct SceneSectionData {
+    const void *data;
+    uint32_t count;
+    uint32_t stride;
+};
+
+template<typename T>
+static SceneSectionData section_data(const std::vector<T> &items) {
+    return SceneSectionData{items.data(), (uint32_t) items.size(), (uint32_t) sizeof(T)};
+}
+
+//===api=====================
+uint32_t scene_writer_add_entity(SceneWriter &writer) {
+    return writer.entityCount++;
+}
+
+uint32_t scene_writer_add_transform(SceneWriter &writer, const Transform &transform, const uint32_t parent) {
+    ASSERT_MSG(parent == SCENE_NONE || parent < writer.transforms.size(), "Err: scene transform parent %u hasn't been added yet", parent);
+    writer.transforms.push_back(transform);
+    writer.transformParents.push_back(parent);
+    return (uint32_t) writer.transforms.size() - 1;
+}
+
+uint32_t scene_writer_add_ui_transform(SceneWriter &writer, const UiTransform &uiTransform) {
+    writer.uiTransforms.push_back(uiTransform);
+    return (uint32_t) writer.uiTransforms.size() - 1;
+}
+
+uint32_t scene_writer_add_camera(SceneWriter &writer, const Camera &camera) {
+    writer.cameras.push_back(camera);
+    return (uint32_t) writer.cameras.size() - 1;
+}
+
+uint32_t scene_writer_add_mesh(SceneWriter &writer, const SceneMeshSource source) {
+    writer.meshes.push_back(SceneMesh{source});
+    return (uint32_t) writer.meshes.size() - 1;
+}
+
+uint32_t scene_writer_add_texture(SceneWriter &writer, const std::string &path) {
+    const auto found = writer.textureIndices.find(path);
+    if (found != writer.textureIndices.end()) {
+        return found->second;
+    }
+    const SceneTexture texture{(uint32_t) writer.strings.size(), (uint32_t) path.size()};
+    writer.strings.insert(writer.strings.end(), path.begin(), path.end());
+    writer.strings.push_back('\0');
+    writer.textures.push_back(texture);
+    writer.textureIndices[path] = (uint32_t) writer.textures.size() - 1;
+    return (uint32_t) writer.textures.size() - 1;
+}
+
+uint32_t scene_writer_add_lit_material(SceneWriter &writer, const uint32_t albedoTexture) {
+    ASSERT_MSG(albedoTexture < writer.textures.size(), "Err: scene texture %u hasn't been added yet", albedoTexture);
+    writer.litMaterials.push_back(SceneLitMaterial{albedoTexture});
+    return (uint32_t) writer.litMaterials.size() - 1;
+}
+
+uint32_t scene_writer_add_font_material(SceneWriter &writer, const uint32_t atlasTexture) {
+    ASSERT_MSG(atlasTexture < writer.textures.size(), "Err: scene texture %u hasn't been added yet", atlasTexture);
+    writer.fontMaterials.push_back(SceneFontMaterial{atlasTexture});
+    return (uint32_t) writer.fontMaterials.size() - 1;
+}
+
+void scene_writer_add_transform_component(SceneWriter &writer, const uint32_t entity, const uint32_t transform) {
+    add_component(writer.transformComponents, writer.entityCount, entity, transform, writer.transforms.size());
+}
+
+void scene_writer_add_ui_transform_component(SceneWriter &writer, const uint32_t entity, const uint32_t uiTransform) {
+    add_component(writer.uiTransformComponents, writer.entityCount, entity, uiTransform, writer.uiTransforms.size());
+}
+
+void scene_writer_add_camera_component(SceneWriter &writer, const uint32_t entity, const uint32_t camera) {
+    add_component(writer.cameraComponents, writer.entityCount, entity, camera, writer.cameras.size());
+}
+
+void scene_writer_add_mesh_component(SceneWriter &writer, const uint32_t entity, const uint32_t mesh) {
+    add_component(writer.meshComponents, writer.entityCount, entity, mesh, writer.meshes.size());
+}
+
+void scene_writer_add_lit_material_component(SceneWriter &writer, const uint32_t entity, const uint32_t litMaterial) {
+    add_component(writer.litMaterialComponents, writer.entityCount, entity, litMaterial, writer.litMaterials.size());
+}
+
+void scene_writer_add_font_material_component(SceneWriter &writer, const uint32_t entity, const uint32_t fontMaterial) {
+    add_component(writer.fontMaterialComponents, writer.entityCount, entity, fontMaterial, writer.fontMaterials.size());
+}
+
+void pipeline_write_scene(const SceneWriter &writer, const std::string &writePath) {
+    BEET_PROFILE_SCOPE("pipeline_write_scene");
+    const std::string outPath = fmt::format("{}{}", CLIENT_RUNTIME_SCENE_DIR, writePath);
+
+    // same order as SceneSection.
+    const SceneSectionData sections[(uint32_t) SceneSection::Count] = {
+            section_data(writer.transforms),
+            section_data(writer.transformParents),
+            section_data(writer.uiTransforms),
+            section_data(writer.cameras),
+            section_data(writer.meshes),
+            section_data(writer.textures),
+            section_data(writer.litMaterials),
+            section_data(writer.fontMaterials),
+            section_data(writer.strings),
+            section_data(writer.transformComponents),
+            section_data(writer.uiTransformComponents),
+            section_data(writer.cameraComponents),
+            section_data(writer.meshComponents),
+            section_data(writer.litMaterialComponents),
+            section_data(writer.fontMaterialComponents),
+    };
+
+    SceneHeader header{};
+    header.magic = SCENE_MAGIC;
+    header.version = SCENE_VERSION;
+    header.entityCount = writer.entityCount;
+    header.sectionCount = (uint32_t) SceneSection::Count;
+    uint64_t offset = align_offset(sizeof(SceneHeader));
+    for (uint32_t i = 0; i < (uint32_t) SceneSection::Count; ++i) {
+        header.sections[i] = SceneSectionInfo{offset, sections[i].count, sections[i].stride};
+        offset = align_offset(offset + (uint64_t) sections[i].count * sections[i].stride);
+    }
+    header.fileSize = offset;
+
+    std::filesystem::create_directories(std::filesystem::path(outPath).parent_path());
+    FILE *fileWrite = fopen(outPath.c_str(), "wb");
+    ASSERT_MSG(fileWrite != nullptr, "Err: failed to write scene at path: %s ", outPath.c_str())
+
+    const unsigned char padding[SCENE_SECTION_ALIGNMENT] = {};
+    fwrite(&header, sizeof(SceneHeader), 1, fileWrite);
+    uint64_t written = sizeof(SceneHeader);
+    for (uint32_t i = 0; i < (uint32_t) SceneSection::Count; ++i) {
+        fwrite(padding, 1, header.sections[i].offset - written, fileWrite);
+        const size_t bytes = (size_t) sections[i].count * sections[i].stride;
+        if (bytes > 0) {
+            fwrite(sections[i].data, 1, bytes, fileWrite);
+        }
+        written = header.sections[i].offset + bytes;
+    }
+    fwrite(padding, 1, header.fileSize - written, fileWrite);
+    fclose(fileWrite);
+
+    log_info(MSG_PIPELINE, "scene: %s entities: %u bytes: %llu\n", outPath.c_str(), writer.entityCount, (unsigned long long) header.fileSize);
+}
@@ -3,10 +3,12 @@
 #include <pipeline/pipeline_cache.h>
 
 #include <shared/log.h>
+#include <shared/profiler.h>
 
 #include <fmt/format.h>
 
 void pipeline_build_shader_spv(const std::string &readPath, const std::string &writePath) {
+    BEET_PROFILE_SCOPE("pipeline_build_shader_spv");
     const std::string inPath = fmt::format("{}{}", PIPELINE_RES_DIR, readPath);
     const std::string outPath = fmt::format("{}{}", CLIENT_RUNTIME_RES_DIR, writePath);
     const std::string cmd = fmt::format("{} {} {} {}", GLSL_VALIDATOR_EXE_PATH, "-V -o", outPath, inPath);
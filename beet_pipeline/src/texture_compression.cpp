@@ -7,6 +7,7 @@
 #include <pipeline/pipeline_cache.h>
 
 #include <shared/assert.h>
+#include <shared/profiler.h>
 
 #include <ostream>
 #include <fstream>
@@ -19,7 +20,7 @@ void pipeline_build_compressed_textures(const std::string &readPath,
                                         const TextureFormat format,
                                         const bool generateMipsMaps = true,
                                         const bool loadFromClientDir) {
-
+    BEET_PROFILE_SCOPE("pipeline_build_compressed_textures");
 
     const std::string inPath = fmt::format("{}{}", loadFromClientDir ? CLIENT_RUNTIME_RES_DIR : PIPELINE_RES_DIR , readPath);
     const std::string outPath = fmt::format("{}{}", CLIENT_RUNTIME_RES_DIR, writePath);